@@ -0,0 +1,101 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <spot/parseaut/public.hh>
+#include <spot/twa/twagraph.hh>
+#include <spot/misc/random.hh>
+#include <spot/misc/timer.hh>
+#include <algorithm>
+#include <iostream>
+
+typedef spot::twa_graph::graph_t::edge_storage_t tr_t;
+
+static bool
+same_edges(const spot::const_twa_graph_ptr& a,
+           const spot::const_twa_graph_ptr& b)
+{
+  auto& ea = a->edge_vector();
+  auto& eb = b->edge_vector();
+  if (ea.size() != eb.size())
+    return false;
+  for (unsigned t = 1; t < ea.size(); ++t)
+    if (ea[t].src != eb[t].src || ea[t].dst != eb[t].dst
+        || ea[t].cond != eb[t].cond || ea[t].acc != eb[t].acc)
+      return false;
+  return true;
+}
+
+static int
+process(const std::string& filename, const spot::bdd_dict_ptr& dict)
+{
+  spot::automaton_stream_parser parser(filename);
+  int status = 0;
+  for (;;)
+    {
+      auto paut = parser.parse(dict);
+      if (paut->format_errors(std::cerr))
+        return 2;
+      if (!paut->aut)
+        return status;
+      auto& aut = paut->aut;
+      aut->get_graph().remove_dead_edges_();
+      auto& v = aut->edge_vector();
+      spot::mrandom_shuffle(v.begin() + 1, v.end());
+      auto copy = spot::make_twa_graph(aut, spot::twa::prop_set::all());
+
+      spot::stopwatch sw;
+      sw.start();
+      aut->get_graph().sort_edges_([](const tr_t& lhs, const tr_t& rhs)
+                                   {
+                                     if (lhs.src != rhs.src)
+                                       return lhs.src < rhs.src;
+                                     if (lhs.dst != rhs.dst)
+                                       return lhs.dst < rhs.dst;
+                                     return lhs.acc < rhs.acc;
+                                   });
+      double t_stable = sw.stop();
+
+      sw.start();
+      copy->get_graph().radix_sort_edges_([](const tr_t& t)
+                                          {
+                                            return t.acc.id;
+                                          });
+      double t_radix = sw.stop();
+
+      if (!same_edges(aut, copy))
+        {
+          std::cerr << filename << ": sorts disagree\n";
+          status = 1;
+        }
+      std::cout << aut->num_states() << ',' << aut->num_edges() << ','
+                << t_stable << ',' << t_radix << std::endl;
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+  auto dict = spot::make_bdd_dict();
+  if (argc < 2)
+    return process("-", dict);
+  int status = 0;
+  for (int i = 1; i < argc; ++i)
+    status = std::max(status, process(argv[i], dict));
+  return status;
+}
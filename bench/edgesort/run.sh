@@ -0,0 +1,32 @@
+#!/bin/sh
+# -*- coding: utf-8 -*-
+# Copyright (C) 2018 Laboratoire de Recherche et Développement
+# de l'Epita (LRDE).
+#
+# This file is part of Spot, a model checking library.
+#
+# Spot is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# Spot is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+# License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Sort the edges of random automata of increasing sizes.
+
+set -e
+randaut=../../bin/randaut
+
+echo states,edges,stable_sort,radix_sort
+# The density is chosen to give about 8 edges per state.
+for n in 10000 100000 1000000; do
+  d=`echo $n | awk '{print 7/($1-1)}'`
+  $randaut --seed=0 -n3 -Q$n -e$d -A 'generalized-Buchi 3' 3 |
+    ./edgesort
+done
@@ -1271,7 +1271,11 @@ namespace
 
       if (matched && (opt_sccs_set | opt_art_sccs_set))
         {
-          spot::scc_info si(aut);
+          // Only the number and the kinds of SCCs matter here, so
+          // their numbering may differ from the sequential one.
+          spot::scc_info si(aut, spot::scc_info_options::ALL
+                            | spot::scc_info_options::PARALLEL,
+                            spot::parallel_policy(0));
           unsigned n = si.scc_count();
           matched = opt_sccs.contains(n);
 
@@ -30,6 +30,7 @@
 #include <ctype.h>
 #include <spot/misc/escape.hh>
 #include <spot/twa/bddprint.hh>
+#include <spot/twaalgos/binary.hh>
 #include <spot/twaalgos/dot.hh>
 #include <spot/twaalgos/hoa.hh>
 #include <spot/twaalgos/isunamb.hh>
@@ -77,7 +78,8 @@ ARGMATCH_VERIFY(check_args, check_types);
 unsigned opt_check = 0U;
 
 enum {
-  OPT_LBTT = 1,
+  OPT_BINARY = 1,
+  OPT_LBTT,
   OPT_NAME,
   OPT_STATS,
   OPT_CHECK,
@@ -87,6 +89,9 @@ static const argp_option options[] =
   {
     /**************************************************/
     { nullptr, 0, nullptr, 0, "Output format:", 3 },
+    { "binary", OPT_BINARY, nullptr, 0,
+      "Spot's binary format, for fast reloading by autfilt on the same "
+      "machine (binary files cannot be read from standard input)", 0 },
     { "dot", 'd',
       "1|a|A|b|B|c|C(COLOR)|e|f(FONT)|h|k|n|N|o|r|R|s|t|v|y|+INT|<INT|#",
       OPTION_ARG_OPTIONAL,
@@ -318,6 +323,9 @@ int parse_opt_aoutput(int key, char* arg, struct argp_state*)
         type = spot::postprocessor::BA;
       automaton_format_opt = arg;
       break;
+    case OPT_BINARY:
+      automaton_format = Binary;
+      break;
     case OPT_CHECK:
       automaton_format = Hoa;
       if (arg)
@@ -598,6 +606,9 @@ automaton_printer::print(const spot::twa_graph_ptr& aut,
     case Quiet:
       // Do not output anything.
       break;
+    case Binary:
+      spot::print_binary(*out, aut);
+      break;
     case Dot:
       spot::print_dot(*out, aut, automaton_format_opt);
       break;
@@ -36,6 +36,7 @@
 
 // Format for automaton output
 enum automaton_format_t {
+  Binary,
   Dot,
   Lbtt,
   Spin,
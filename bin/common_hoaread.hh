@@ -31,6 +31,7 @@
 
 #include "common_finput.hh"
 #include <spot/parseaut/public.hh>
+#include <spot/twaalgos/binary.hh>
 
 
 extern const struct argp hoaread_argp;
@@ -117,10 +118,27 @@ public:
           }
       }
 
+    if (spot::binary_aut_reader::is_binary(filename))
+      return process_binary_file(filename);
+
     return process_automaton_stream(spot::automaton_stream_parser(filename,
                                                                   opt_parse));
   }
 
+  int process_binary_file(const char* filename)
+  {
+    spot::binary_aut_reader reader(filename);
+    while (!abort_run)
+      {
+        auto haut = std::make_shared<spot::parsed_aut>(filename);
+        haut->aut = reader.read(dict_);
+        if (!haut->aut)
+          break;
+        process_automaton(haut);
+      }
+    return 0;
+  }
+
   int process_automaton_stream(spot::automaton_stream_parser&& hp)
   {
     int err = 0;
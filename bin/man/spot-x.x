@@ -39,10 +39,31 @@ This naive method tries to reduce the size of the automaton one state at a
 time. Note that it restarts all the encoding each time.
 
 [ENVIRONMENT VARIABLES]
+.TP
+\fBSPOT_BDD_CACHE_GROWTH\fR
+Each BDD operation (apply, ite, quantification, ...) has its own cache
+whose size is adjusted after each garbage collection according to its
+hit rate.  This variable sets how many times larger than its initial
+size a cache may grow (default: 8).  Set it to 1 to keep all caches at
+the same fixed size.
+
+.TP
+\fBSPOT_BDD_REORDER\fR
+Enable the dynamic reordering of BDD variables, using the given
+method: \fBsift\fR, \fBsiftite\fR, \fBwin2\fR, \fBwin2ite\fR,
+\fBwin3\fR, \fBwin3ite\fR, or \fBrandom\fR.  Reordering is then
+triggered automatically when the number of BDD nodes in use grows past
+some threshold.  It is disabled by default, because it does not always
+pay off, and because it may change the order in which the labels of
+edges are output.
+
 .TP
 \fBSPOT_BDD_TRACE\fR
 If this variable is set to any value, statistics about BDD garbage
-collection and resizing will be output on standard error.
+collection and resizing will be output on standard error.  These
+include the size, number of hits and misses, and number of resizes of
+the cache used by each BDD operation, and are printed once more when
+the program exits.
 
 .TP
 \fBSPOT_DEFAULT_FORMAT\fR
@@ -219,6 +240,15 @@ sl(a) x sl(!a), performed on-the-fly
 cl(a) x cl(!a)
 .RE
 
+.TP
+\fBSPOT_THREADS\fR
+The maximum number of threads used by the command-line tools in the
+algorithms that have a parallel implementation, when Spot has been
+configured with \fB--enable-pthread\fR.  By default, this is the
+number of hardware threads.  These algorithms only start threads on
+large inputs, so small automata are always processed sequentially.
+Set this variable to 1 to disable threads completely.
+
 .TP
 \fBSPOT_TMPDIR\fR, \fBTMPDIR\fR
 These variables control in which directory temporary files (e.g.,
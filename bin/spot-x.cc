@@ -63,6 +63,11 @@ only if it is smaller than the original skeleton.  This option is only \
 used when comp-susp=1 and default to 1 or 2 depending on whether --small \
 or --deterministic is specified.") },
     { nullptr, 0, nullptr, 0, "Postprocessing options:", 0 },
+    { DOC("arena", "Set to 1 to allocate the storage of all automata \
+built during translation and post-processing from a memory arena that \
+is released at once, after the final automaton has been moved out of \
+it.  This saves many calls to malloc() and free() when processing many \
+small automata.  Disabled by default.") },
     { DOC("scc-filter", "Set to 1 (the default) to enable \
 SCC-pruning and acceptance simplification at the beginning of \
 post-processing. Transitions that are outside of accepting SCC are \
@@ -47,7 +47,7 @@ static int  bdd_loaddata(FILE *);
 static int  loadhash_get(int);
 static void loadhash_add(int, int);
 
-static bddfilehandler filehandler;
+static BDD_TLS bddfilehandler filehandler;
 
 typedef struct s_LoadHash
 {
@@ -57,10 +57,10 @@ typedef struct s_LoadHash
    int next;
 } LoadHash;
 
-static LoadHash *lh_table;
-static int       lh_freepos;
-static int       lh_nodenum;
-static int      *loadvar2level;
+static BDD_TLS LoadHash *lh_table;
+static BDD_TLS int       lh_freepos;
+static BDD_TLS int       lh_nodenum;
+static BDD_TLS int      *loadvar2level;
 
 /*=== PRINTING ========================================================*/
 
@@ -564,6 +564,87 @@ static int bdd_loaddata(FILE *ifile)
 }
 
 
+/*
+NAME    {* bdd\_loadarray *}
+SECTION {* fileio *}
+SHORT   {* builds BDDs from an array of nodes *}
+PROTO   {* int bdd_loadarray(const int *nodes, int nodenum, BDD *res) *}
+DESCR   {* This is the in-memory counterpart of {\tt bdd\_load}, meant
+           for BDDs stored in a binary file that has been read or
+	   mapped into memory.  The array {\tt nodes} contains
+	   {\tt nodenum} triples of integers: the variable number, the
+	   low node, and the high node.  Nodes are designated by $0$
+	   (the constant false), $1$ (the constant true), or $n+2$
+	   for the $n$th triple, which must precede the triple that
+	   refers to it.  Upon success, {\tt res[n]} is set to the BDD
+	   rooted at the $n$th node, and this BDD is referenced: the
+	   caller should call {\tt bdd\_delref} on each of them when
+	   done.
+
+	   When the variable of a node is above the variables of its
+	   children in the current order (e.g., when the nodes were
+	   saved with the same variable order), the node is inserted
+	   directly in the node table, without going through
+	   {\tt bdd\_ite} and the operator caches.  Reordering is
+	   disabled during the load. *}
+ALSO    {* bdd\_load *}
+RETURN  {* Zero on succes, otherwise an error code from {\tt bdd.h}.
+           In case of error, no BDD is referenced. *}
+*/
+int bdd_loadarray(const int *nodes, int nodenum, BDD *res)
+{
+   int n, err = 0;
+
+   if (!bddrunning)
+      return bdd_error(BDD_RUNNING);
+   if (nodenum < 0)
+      return bdd_error(BDD_RANGE);
+
+   bdd_disable_reorder();
+
+   for (n=0 ; n<nodenum ; n++)
+   {
+      int var = nodes[3*n];
+      int low = nodes[3*n+1];
+      int high = nodes[3*n+2];
+      int level, root;
+
+      if (var < 0  ||  var >= bddvarnum  ||  low < 0  ||  low >= n+2
+	  ||  high < 0  ||  high >= n+2)
+      {
+	 err = bdd_error(BDD_FORMAT);
+	 break;
+      }
+
+      if (low >= 2)
+	 low = res[low-2];
+      if (high >= 2)
+	 high = res[high-2];
+
+      level = bddvar2level[var];
+      if (level < LEVEL(low)  &&  level < LEVEL(high))
+	 root = bdd_makenode(level, low, high);
+      else
+	 root = bdd_ite(bdd_ithvar(var), high, low);
+
+      if (bdderrorcond)
+      {
+	 err = -bdderrorcond;
+	 break;
+      }
+
+      res[n] = bdd_addref(root);
+   }
+
+   if (err < 0)
+      while (n-- > 0)
+	 bdd_delref(res[n]);
+
+   bdd_enable_reorder();
+   return err;
+}
+
+
 static void loadhash_add(int key, int data)
 {
    int hash = key % lh_nodenum;
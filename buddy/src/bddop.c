@@ -92,40 +92,43 @@ static int oprres[OPERATOR_NUM][4] =
 
 
    /* Variables needed for the operators */
-static int applyop;                 /* Current operator for apply */
-static int appexop;                 /* Current operator for appex */
-static int appexid;                 /* Current cache id for appex */
-static int quantid;                 /* Current cache id for quantifications */
-static int *quantvarset;            /* Current variable set for quant. */
-static int quantvarsetcomp;         /* Should quantvarset be complemented?  */
-static int quantvarsetID;           /* Current id used in quantvarset */
-static int quantlast;               /* Current last variable to be quant. */
-static int replaceid;               /* Current cache id for replace */
-static int *replacepair;            /* Current replace pair */
-static int replacelast;             /* Current last var. level to replace */
-static int composelevel;            /* Current variable used for compose */
-static int miscid;                  /* Current cache id for other results */
-static int *varprofile;             /* Current variable profile */
-static int supportID;               /* Current ID (true value) for support */
-static int supportMin;              /* Min. used level in support calc. */
-static int supportMax;              /* Max. used level in support calc. */
-static int* supportSet;             /* The found support set */
-static BddCache applycache;         /* Cache for apply results */
-static BddCache itecache;           /* Cache for ITE results */
-static BddCache quantcache;         /* Cache for exist/forall results */
-static BddCache appexcache;         /* Cache for appex/appall results */
-static BddCache replacecache;       /* Cache for replace results */
-static BddCache misccache;          /* Cache for other results */
-static int cacheratio;
-static BDD satPolarity;
-static int firstReorder;            /* Used instead of local variable in order
+static BDD_TLS int applyop;                 /* Current operator for apply */
+static BDD_TLS int appexop;                 /* Current operator for appex */
+static BDD_TLS int appexid;                 /* Current cache id for appex */
+static BDD_TLS int quantid;                 /* Current cache id for quantifications */
+static BDD_TLS int *quantvarset;            /* Current variable set for quant. */
+static BDD_TLS int quantvarsetcomp;         /* Should quantvarset be complemented?  */
+static BDD_TLS int quantvarsetID;           /* Current id used in quantvarset */
+static BDD_TLS int quantlast;               /* Current last variable to be quant. */
+static BDD_TLS int replaceid;               /* Current cache id for replace */
+static BDD_TLS int *replacepair;            /* Current replace pair */
+static BDD_TLS int replacelast;             /* Current last var. level to replace */
+static BDD_TLS int composelevel;            /* Current variable used for compose */
+static BDD_TLS int miscid;                  /* Current cache id for other results */
+static BDD_TLS int *varprofile;             /* Current variable profile */
+static BDD_TLS int supportID;               /* Current ID (true value) for support */
+static BDD_TLS int supportMin;              /* Min. used level in support calc. */
+static BDD_TLS int supportMax;              /* Max. used level in support calc. */
+static BDD_TLS int* supportSet;             /* The found support set */
+static BDD_TLS BddCache applycache;         /* Cache for apply results */
+static BDD_TLS BddCache itecache;           /* Cache for ITE results */
+static BDD_TLS BddCache quantcache;         /* Cache for exist/forall results */
+static BDD_TLS BddCache appexcache;         /* Cache for appex/appall results */
+static BDD_TLS BddCache replacecache;       /* Cache for replace results */
+static BDD_TLS BddCache misccache;          /* Cache for other results */
+static BDD_TLS int cacheratio;
+static BDD_TLS int cachenominal;            /* Size of the caches before adaptation */
+static BDD_TLS int cachemaxshift;           /* log2 of the max. cache growth */
+static BDD_TLS int cacheadapt;              /* Adapt caches at next checkresize */
+static BDD_TLS BDD satPolarity;
+static BDD_TLS int firstReorder;            /* Used instead of local variable in order
 				       to avoid compiler warning about 'first'
 				       being clobbered by setjmp */
 
-static char*            allsatProfile; /* Variable profile for bdd_allsat() */
-static bddallsathandler allsatHandler; /* Callback handler for bdd_allsat() */
+static BDD_TLS char* allsatProfile;   /* Variable profile for bdd_allsat() */
+static BDD_TLS bddallsathandler allsatHandler; /* Callback for bdd_allsat() */
 
-extern bddCacheStat bddcachestats;
+extern BDD_TLS bddCacheStat bddcachestats;
 
    /* Internal prototypes */
 static BDD    not_rec(BDD);
@@ -206,9 +209,19 @@ int bdd_operator_init(int cachesize)
    if (BddCache_init(&misccache,cachesize) < 0)
       return bdd_error(BDD_MEMORY);
 
+   applycache.name = "apply";
+   itecache.name = "ite";
+   quantcache.name = "quant";
+   appexcache.name = "appex";
+   replacecache.name = "replace";
+   misccache.name = "misc";
+
    quantvarsetID = 0;
    quantvarset = NULL;
    cacheratio = 0;
+   cachenominal = cachesize;
+   cachemaxshift = 0;
+   cacheadapt = 0;
    supportSet = NULL;
 
    return 0;
@@ -243,6 +256,37 @@ void bdd_operator_reset(void)
 }
 
 
+static void bdd_operator_adapt(BddCache *cache, int nominal)
+{
+   if (BddCache_adapt(cache, nominal, cachemaxshift) < 0)
+      bdd_error(BDD_MEMORY);
+}
+
+
+/* Called by the garbage collector instead of bdd_operator_reset().
+   The garbage collection may occur in the middle of an operation
+   whose recursive calls still hold pointers to cache entries, so
+   the caches are only emptied here.  Adapting their size to the hit
+   rate observed since the last collection is done by checkresize()
+   once the operation is over. */
+void bdd_operator_gbc(void)
+{
+   bdd_operator_reset();
+   cacheadapt = 1;
+}
+
+
+static void bdd_operator_adaptall(void)
+{
+   bdd_operator_adapt(&applycache, cachenominal);
+   bdd_operator_adapt(&itecache, cachenominal);
+   bdd_operator_adapt(&quantcache, cachenominal);
+   bdd_operator_adapt(&appexcache, cachenominal);
+   bdd_operator_adapt(&replacecache, cachenominal);
+   bdd_operator_adapt(&misccache, cachenominal);
+}
+
+
 void bdd_operator_varresize(void)
 {
    if (quantvarset != NULL)
@@ -261,13 +305,20 @@ static void bdd_operator_noderesize(void)
    if (cacheratio > 0)
    {
       int newcachesize = bddnodesize / cacheratio;
-      BddCache_resize(&applycache, newcachesize);
-      BddCache_resize(&itecache, newcachesize);
-      BddCache_resize(&quantcache, newcachesize);
-      BddCache_resize(&appexcache, newcachesize);
-      BddCache_resize(&replacecache, newcachesize);
-      BddCache_resize(&misccache, newcachesize);
-      bddcachesize = misccache.tablesize;
+      cachenominal = newcachesize;
+      BddCache_resize(&applycache,
+                      CACHE_SHIFTSIZE(newcachesize, applycache.shift));
+      BddCache_resize(&itecache,
+                      CACHE_SHIFTSIZE(newcachesize, itecache.shift));
+      BddCache_resize(&quantcache,
+                      CACHE_SHIFTSIZE(newcachesize, quantcache.shift));
+      BddCache_resize(&appexcache,
+                      CACHE_SHIFTSIZE(newcachesize, appexcache.shift));
+      BddCache_resize(&replacecache,
+                      CACHE_SHIFTSIZE(newcachesize, replacecache.shift));
+      BddCache_resize(&misccache,
+                      CACHE_SHIFTSIZE(newcachesize, misccache.shift));
+      bddcachesize = newcachesize;
    }
 }
 
@@ -307,6 +358,75 @@ int bdd_setcacheratio(int r)
 }
 
 
+/*
+NAME    {* bdd\_setmaxcachegrowth *}
+SECTION {* kernel *}
+SHORT   {* Let the operator caches adapt their size to their usage *}
+PROTO   {* int bdd_setmaxcachegrowth(int f) *}
+DESCR   {* By default, all the operator caches have the same size, set
+	   by {\tt bdd\_init} or {\tt bdd\_setcacheratio}.  When
+	   {\tt f} is larger than one, each cache may instead grow up to
+	   {\tt f} times this nominal size (rounded down to a power of
+	   two).  After each garbage collection, a cache that was filled
+	   since the previous collection while keeping a good hit rate is
+	   doubled, and a cache that was barely used is halved, never
+	   going below the nominal size.  Passing 1 disables this and
+	   returns all caches to their nominal size at the next garbage
+	   collection. *}
+RETURN  {* The previous growth factor or a negative number on error. *}
+ALSO    {* bdd\_setcacheratio, bdd\_opcachestats *}
+*/
+int bdd_setmaxcachegrowth(int f)
+{
+   int old = 1 << cachemaxshift;
+   int shift = 0;
+
+   if (f < 1)
+      return bdd_error(BDD_RANGE);
+
+   while (f > 1 && shift < 20)
+   {
+      f >>= 1;
+      ++shift;
+   }
+   cachemaxshift = shift;
+   return old;
+}
+
+
+/*
+NAME    {* bdd\_opcachestats *}
+SECTION {* kernel *}
+SHORT   {* Fetch usage statistics for each operator cache *}
+PROTO   {* int bdd_opcachestats(bddOpCacheStat *s, int n) *}
+DESCR   {* Stores the statistics of at most {\tt n} operator caches in
+	   the array {\tt s}.  Unlike {\tt bdd\_cachestats}, these
+	   statistics are always collected.  There are
+	   {\tt BDD\_OPCACHENUM} operator caches.  *}
+RETURN  {* The number of entries written in {\tt s}. *}
+ALSO    {* bddOpCacheStat, bdd\_setmaxcachegrowth, bdd\_printstat *}
+*/
+int bdd_opcachestats(bddOpCacheStat *s, int n)
+{
+   BddCache *caches[BDD_OPCACHENUM] =
+      { &applycache, &itecache, &quantcache,
+	&appexcache, &replacecache, &misccache };
+   int i;
+
+   if (n > BDD_OPCACHENUM)
+      n = BDD_OPCACHENUM;
+   for (i = 0; i < n; ++i)
+   {
+      s[i].name = caches[i]->name;
+      s[i].size = caches[i]->tablesize;
+      s[i].hits = caches[i]->hits;
+      s[i].misses = caches[i]->misses;
+      s[i].resizes = caches[i]->resizes;
+   }
+   return n;
+}
+
+
 /*************************************************************************
   Operators
 *************************************************************************/
@@ -316,6 +436,11 @@ static void checkresize(void)
    if (bddresized)
       bdd_operator_noderesize();
    bddresized = 0;
+   if (cacheadapt)
+   {
+      cacheadapt = 0;
+      bdd_operator_adaptall();
+   }
 }
 
 
@@ -404,7 +529,9 @@ SHORT   {* negates a bdd *}
 PROTO   {* BDD bdd_not(BDD r) *}
 DESCR   {* Negates the BDD {\tt r} by exchanging
 	   all references to the zero-terminal with references to the
-	   one-terminal and vice versa. *}
+	   one-terminal and vice versa.  Each negated node is cached in
+	   both directions, so negating the result again costs a single
+	   cache lookup until the next garbage collection. *}
 RETURN  {* The negated bdd. *}
 */
 BDD bdd_not(BDD r)
@@ -457,14 +584,10 @@ static BDD not_rec(BDD r)
 
    if (entry->i.a == r  &&  entry->i.c == bddop_not)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&applycache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&applycache);
 
    PUSHREF( not_rec(LOW(r)) );
    PUSHREF( not_rec(HIGH(r)) );
@@ -475,6 +598,14 @@ static BDD not_rec(BDD r)
    entry->i.c = bddop_not;
    entry->i.res = res;
 
+   /* Negation is an involution: also remember that r is the negation
+      of res, so that negating the result again (something Spot does
+      a lot) is answered by a single cache lookup. */
+   entry = BddCache_lookup(&applycache, NOTHASH(res));
+   entry->i.a = res;
+   entry->i.c = bddop_not;
+   entry->i.res = r;
+
    return res;
 }
 
@@ -565,6 +696,91 @@ BDD bdd_apply(BDD l, BDD r, int op)
 }
 
 
+/*
+NAME    {* bdd\_applyarray *}
+SECTION {* operator *}
+SHORT   {* basic bdd operations on arrays of operands *}
+PROTO   {* int bdd_applyarray(const BDD *left, const BDD *right, BDD *res, int num, int opr) *}
+DESCR   {* Computes {\tt res[n] = bdd\_apply(left[n], right[n], opr)}
+	   for each $0 \leq n < {\tt num}$.  This is equivalent to
+	   {\tt num} calls to {\tt bdd\_apply}, except that the
+	   arguments are checked and the operator is set up only once,
+	   and that the loop runs without returning to the caller, so
+	   that the operator cache and the nodes of operands that are
+	   used repeatedly stay warm.  Each result is referenced, so
+	   that it survives garbage collections triggered while
+	   computing the next ones: the caller should call
+	   {\tt bdd\_delref} on each of them when done.  If a
+	   reordering is triggered by the batch, the current operation
+	   is restarted, and the rest of the batch runs with reordering
+	   disabled. *}
+RETURN  {* Zero on success, otherwise an error code from {\tt bdd.h}.
+	   In case of error, no result is referenced. *}
+ALSO    {* bdd\_apply *}
+*/
+int bdd_applyarray(const BDD *l, const BDD *r, BDD *res, int num, int op)
+{
+   /* n is modified between setjmp() and longjmp(). */
+   volatile int n;
+
+   if (!bddrunning)
+      return bdd_error(BDD_RUNNING);
+   if (op<0 || op>bddop_invimp)
+      return bdd_error(BDD_OP);
+   for (n=0 ; n<num ; n++)
+   {
+      CHECK(l[n]);
+      CHECK(r[n]);
+   }
+
+   n = 0;
+   firstReorder = 1;
+
+ again:
+   if (__likely(bddreordermethod == BDD_REORDER_NONE)
+       || setjmp(bddexception) == 0)
+   {
+      applyop = op;
+
+      if (__likely(firstReorder))
+      {
+	 for (; n<num ; n++)
+	 {
+	    INITREF;
+	    res[n] = bdd_addref(apply_rec(l[n], r[n]));
+	 }
+      }
+      else
+      {
+	 bdd_disable_reorder();
+	 for (; n<num ; n++)
+	 {
+	    INITREF;
+	    res[n] = bdd_addref(apply_rec(l[n], r[n]));
+	 }
+	 bdd_enable_reorder();
+      }
+   }
+   else
+   {
+      bdd_checkreorder();
+
+      if (firstReorder-- == 1)
+	 goto again;
+   }
+
+   checkresize();
+
+   if (bdderrorcond)
+   {
+      while (n-- > 0)
+	 bdd_delref(res[n]);
+      return -bdderrorcond;
+   }
+   return 0;
+}
+
+
 static BDD apply_rec(BDD l, BDD r)
 {
    BddCacheData *entry;
@@ -679,6 +895,33 @@ static BDD apply_rec(BDD l, BDD r)
       use + when we do not want to call any function.*/
    APPLY_SHORTCUTS(applyop, +);
 
+   /* Operations that degenerate into a negation are delegated to
+      not_rec(), whose cache entries work in both directions. */
+   switch (applyop)
+     {
+     case bddop_xor:
+     case bddop_diff:
+       if (ISONE(l))
+         return not_rec(r);
+       break;
+     case bddop_nand:
+       if (l == r || ISONE(l))
+         return not_rec(r);
+       break;
+     case bddop_nor:
+       if (l == r || ISZERO(l))
+         return not_rec(r);
+       break;
+     case bddop_imp:
+       if (ISZERO(r))
+         return not_rec(l);
+       break;
+     case bddop_biimp:
+       if (ISZERO(l))
+         return not_rec(r);
+       break;
+     }
+
    if (__unlikely(ISCONST(l)  &&  ISCONST(r)))
       res = oprres[applyop][l<<1 | r];
    else
@@ -688,14 +931,10 @@ static BDD apply_rec(BDD l, BDD r)
       /* Check entry->c last, because not_rec() does not initialize it. */
       if (entry->i.a == l  &&  entry->i.c == applyop  &&  entry->i.b == r)
       {
-#ifdef CACHESTATS
-	 bddcachestats.opHit++;
-#endif
+	 BddCache_hit(&applycache);
 	 return entry->i.res;
       }
-#ifdef CACHESTATS
-      bddcachestats.opMiss++;
-#endif
+      BddCache_miss(&applycache);
 
       if (LEVEL(l) == LEVEL(r))
       {
@@ -832,14 +1071,10 @@ BDD bdd_setxor(BDD l, BDD r)
    entry = BddCache_lookup(&misccache, SETXORHASH(l,r));
    if (entry->i.a == l &&  entry->i.b == r  && entry->i.c == CACHEID_SETXOR)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&misccache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&misccache);
 
   if (LEVEL(l) == LEVEL(r))
     {
@@ -932,14 +1167,10 @@ int bdd_implies(BDD l, BDD r)
   /* Check entry->b last, because not_rec() does not initialize it. */
   if (entry->i.a == l && entry->i.c == CACHEID_IMPLIES && entry->i.b == r)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&misccache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&misccache);
 
   if (LEVEL(l) == LEVEL(r))
     {
@@ -1053,14 +1284,10 @@ static BDD ite_rec(BDD f, BDD g, BDD h)
    entry = BddCache_lookup(&itecache, ITEHASH(f,g,h));
    if (entry->i.a == f  &&  entry->i.c == h && entry->i.b == g)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&itecache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&itecache);
 
    if (LEVEL(f) == LEVEL(g))
    {
@@ -1226,14 +1453,10 @@ static int restrict_rec(int r)
    entry = BddCache_lookup(&misccache, RESTRHASH(r,miscid));
    if (entry->i.a == r  &&  entry->i.c == miscid)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&misccache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&misccache);
 
    if (INSVARSET(LEVEL(r)))
    {
@@ -1327,14 +1550,10 @@ static BDD constrain_rec(BDD f, BDD c)
    entry = BddCache_lookup(&misccache, CONSTRAINHASH(f,c));
    if (entry->i.a == f  &&  entry->i.b == c  &&  entry->i.c == miscid)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&misccache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&misccache);
 
    if (LEVEL(f) == LEVEL(c))
    {
@@ -1449,14 +1668,10 @@ static BDD replace_rec(BDD r)
    entry = BddCache_lookup(&replacecache, REPLACEHASH(r));
    if (entry->i.a == r  &&  entry->i.c == replaceid)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&replacecache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&replacecache);
 
    PUSHREF( replace_rec(LOW(r)) );
    PUSHREF( replace_rec(HIGH(r)) );
@@ -1584,14 +1799,10 @@ static BDD compose_rec(BDD f, BDD g)
    entry = BddCache_lookup(&replacecache, COMPOSEHASH(f,g));
    if (entry->i.a == f  &&  entry->i.b == g  &&  entry->i.c == replaceid)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&replacecache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&replacecache);
 
    if (LEVEL(f) < composelevel)
    {
@@ -1703,14 +1914,10 @@ static BDD veccompose_rec(BDD f)
    entry = BddCache_lookup(&replacecache, VECCOMPOSEHASH(f));
    if (entry->i.a == f  &&  entry->i.c == replaceid)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&replacecache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&replacecache);
 
    PUSHREF( veccompose_rec(LOW(f)) );
    PUSHREF( veccompose_rec(HIGH(f)) );
@@ -1796,14 +2003,10 @@ static BDD simplify_rec(BDD f, BDD d)
    /* Check entry->b last, because not_rec() does not initialize it. */
    if (entry->i.a == f && entry->i.c == bddop_simplify && entry->i.b == d)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&applycache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&applycache);
 
    if (LEVEL(f) == LEVEL(d))
    {
@@ -1999,14 +2202,10 @@ static int quant_rec(int r)
    entry = BddCache_lookup(&quantcache, QUANTHASH(r));
    if (entry->i.a == r && entry->i.c == quantid)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&quantcache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&quantcache);
 
    PUSHREF( quant_rec(LOW(r)) );
    PUSHREF( quant_rec(HIGH(r)) );
@@ -2242,14 +2441,10 @@ static int appquant_rec(int l, int r)
       entry = BddCache_lookup(&appexcache, APPEXHASH(l,r,appexop));
       if (entry->i.a == l  && entry->i.c == appexid && entry->i.b == r)
       {
-#ifdef CACHESTATS
-	 bddcachestats.opHit++;
-#endif
+	 BddCache_hit(&appexcache);
 	 return entry->i.res;
       }
-#ifdef CACHESTATS
-      bddcachestats.opMiss++;
-#endif
+      BddCache_miss(&appexcache);
 
       if (LEVEL(l) == LEVEL(r))
       {
@@ -2311,7 +2506,7 @@ RETURN  {* A BDD variable set. *}
 BDD bdd_support(BDD r)
 {
    BddCacheData *entry;
-   static int  supportSize = 0;
+   static BDD_TLS int supportSize = 0;
    int n;
    int res=1;
 
@@ -2324,14 +2519,10 @@ BDD bdd_support(BDD r)
    entry = BddCache_lookup(&misccache, SUPPORTHASH(r));
    if (entry->i.a == r && entry->i.c == CACHEID_SUPPORT)
    {
-#ifdef CACHESTATS
-      bddcachestats.opHit++;
-#endif
+      BddCache_hit(&misccache);
       return entry->i.res;
    }
-#ifdef CACHESTATS
-   bddcachestats.opMiss++;
-#endif
+   BddCache_miss(&misccache);
 
       /* On-demand allocation of support set */
    if (__unlikely(supportSize < bddvarnum))
@@ -74,6 +74,165 @@ static void testSupport(void)
 }
 
 
+static void testNot(void)
+{
+  cout << "Testing negation\n";
+
+  bdd a = bdd_ithvar(0);
+  bdd b = bdd_ithvar(1);
+  bdd c = bdd_ithvar(2);
+  bdd f = (a & b) | (!a & c) | bdd_ithvar(3);
+
+  bdd nf = !f;
+  if (nf == f || (nf & f) != bddfalse || (nf | f) != bddtrue)
+    ERROR("Negation failed");
+  if (!nf != f)
+    ERROR("Double negation failed");
+  if (bdd_apply(bddtrue, f, bddop_xor) != nf)
+    ERROR("true xor f failed");
+  if (bdd_apply(f, bddtrue, bddop_xor) != nf)
+    ERROR("f xor true failed");
+  if (bdd_apply(f, f, bddop_nand) != nf)
+    ERROR("f nand f failed");
+  if (bdd_apply(bddtrue, f, bddop_nand) != nf)
+    ERROR("true nand f failed");
+  if (bdd_apply(f, f, bddop_nor) != nf)
+    ERROR("f nor f failed");
+  if (bdd_apply(bddfalse, f, bddop_nor) != nf)
+    ERROR("false nor f failed");
+  if (bdd_apply(f, bddfalse, bddop_imp) != nf)
+    ERROR("f imp false failed");
+  if (bdd_apply(bddfalse, f, bddop_invimp) != nf)
+    ERROR("false invimp f failed");
+  if (bdd_apply(bddfalse, f, bddop_biimp) != nf)
+    ERROR("false biimp f failed");
+  if (bdd_apply(bddtrue, f, bddop_diff) != nf)
+    ERROR("true diff f failed");
+  if (bdd_apply(f, bddtrue, bddop_less) != nf)
+    ERROR("f less true failed");
+
+  /* The reverse cache entries must not survive a garbage collection. */
+  nf = bddfalse;
+  bdd_gbc();
+  for (int n = 0; n < 100; ++n)
+    {
+      bdd g = f ^ bdd_ithvar(4 + n % 6);
+      if (!!g != g || (g & !g) != bddfalse)
+        ERROR("Negation after GC failed");
+    }
+}
+
+
+static int minorgbcnum, freednodes;
+
+static void countgbc(int pre, bddGbcStat *s)
+{
+  if (!pre)
+    {
+      minorgbcnum += s->minor;
+      freednodes += s->freednodes;
+    }
+}
+
+
+static void testMinorGbc(void)
+{
+  cout << "Testing minor garbage collections\n";
+
+  bddgbchandler old = bdd_gbc_hook(countgbc);
+  bdd keep = bddfalse;
+  for (int n = 0; n < 10; ++n)
+    keep |= bdd_ithvar(n) & !bdd_ithvar((n + 3) % 10);
+  double keepcount = bdd_satcount(keep);
+
+  /* Create many short-lived BDDs until the table fills up. */
+  for (int n = 0; n < 2000; ++n)
+    {
+      bdd g = bdd_ithvar(n % 10) & !bdd_ithvar((n / 10) % 10);
+      if (((keep ^ g) ^ g) != keep)
+        ERROR("Xor failed");
+    }
+
+  if (minorgbcnum == 0 || freednodes == 0)
+    ERROR("No minor garbage collection");
+  if (bdd_satcount(keep) != keepcount)
+    ERROR("Long-lived BDD damaged by minor garbage collection");
+  bdd_gbc();
+  if (bdd_satcount(keep) != keepcount)
+    ERROR("Long-lived BDD damaged by full garbage collection");
+  bdd_gbc_hook(old);
+}
+
+
+static void testLoadArray(void)
+{
+  cout << "Testing loading BDDs from an array\n";
+
+  // x0 & (x1 | !x2), with a node whose variable is out of order.
+  const int nodes[] =
+    {
+      2, 1, 0,                  // 2: !x2
+      1, 2, 1,                  // 3: x1 | !x2
+      0, 0, 3,                  // 4: x0 & (x1 | !x2)
+      5, 4, 1,                  // 5: x5 | (x0 & (x1 | !x2))
+    };
+  bdd res[4];
+  if (bdd_loadarray(nodes, 4, res) != 0)
+    ERROR("bdd_loadarray failed");
+  bdd f = bdd_ithvar(0) & (bdd_ithvar(1) | bdd_nithvar(2));
+  if (res[0] != bdd_nithvar(2) || res[2] != f
+      || res[3] != (bdd_ithvar(5) | f))
+    ERROR("bdd_loadarray built wrong BDDs");
+
+  const int bad[] = { 0, 0, 3 };
+  bddinthandler old = bdd_error_hook(NULL);
+  if (bdd_loadarray(bad, 1, res) != BDD_FORMAT)
+    ERROR("bdd_loadarray accepted a forward reference");
+  bdd_error_hook(old);
+}
+
+
+static void testApplyArray(void)
+{
+  cout << "Testing apply on arrays\n";
+
+  const int num = 150;
+  bdd l[num], r[num], res[num];
+  for (int n = 0; n < num; ++n)
+    {
+      l[n] = bdd_ithvar(n % 10) | bdd_nithvar((n / 10) % 10);
+      r[n] = bdd_ithvar((n * 7) % 10) ^ bdd_ithvar((n + 1) % 10);
+    }
+  if (bdd_applyarray(l, r, res, num, bddop_and) != 0)
+    ERROR("bdd_applyarray failed");
+  for (int n = 0; n < num; ++n)
+    if (res[n] != (l[n] & r[n]))
+      ERROR("bdd_applyarray computed a wrong result");
+
+  // The result array may be one of the operands.
+  bdd_gbc();
+  if (bdd_applyarray(res, r, res, num, bddop_or) != 0)
+    ERROR("bdd_applyarray failed");
+  for (int n = 0; n < num; ++n)
+    if (res[n] != r[n])
+      ERROR("bdd_applyarray computed a wrong result in place");
+
+  // Operands may also be gathered through pointers.
+  const bdd* lp[num];
+  const bdd* rp[num];
+  for (int n = 0; n < num; ++n)
+    {
+      lp[n] = &l[(n * 13) % num];
+      rp[n] = &r[num - 1 - n];
+    }
+  if (bdd_applyarray(lp, rp, res, num, bddop_xor) != 0)
+    ERROR("bdd_applyarray failed");
+  for (int n = 0; n < num; ++n)
+    if (res[n] != (*lp[n] ^ *rp[n]))
+      ERROR("bdd_applyarray computed a wrong result with pointers");
+}
+
+
 void testBvecIte()
 {
   cout << "Testing ITE for vector\n";
@@ -104,6 +263,10 @@ int main(int ac, char** av)
   bdd_setvarnum(10);
 
   testSupport();
+  testNot();
+  testMinorGbc();
+  testLoadArray();
+  testApplyArray();
   testBvecIte();
 
   bdd_done();
@@ -184,14 +184,22 @@ PROTO   {* typedef struct s_bddGbcStat
    long time;
    long sumtime;
    int num;
+   int minor;
+   int freednodes;
+   long freedbytes;
 } bddGbcStat;  *}
 DESCR   {* The fields are \\[\baselineskip] \begin{tabular}{ll}
-  {\tt nodes}     & Total number of allocated nodes in the nodetable \\
-  {\tt freenodes} & Number of free nodes in the nodetable \\
-  {\tt time}      & Time used for garbage collection this time \\
-  {\tt sumtime}   & Total time used for garbage collection \\
-  {\tt num}       & number of garbage collections done until now
-  \end{tabular} *}
+  {\tt nodes}      & Total number of allocated nodes in the nodetable \\
+  {\tt freenodes}  & Number of free nodes in the nodetable \\
+  {\tt time}       & Time used for garbage collection this time \\
+  {\tt sumtime}    & Total time used for garbage collection \\
+  {\tt num}        & number of garbage collections done until now \\
+  {\tt minor}      & 1 for a minor collection, 0 for a full one \\
+  {\tt freednodes} & Number of nodes reclaimed by this collection \\
+  {\tt freedbytes} & Memory reclaimed by this collection, in bytes
+  \end{tabular}
+  The last three fields, like {\tt time}, are only meaningful after
+  the collection. *}
 ALSO    {* bdd\_gbc\_hook *}
 */
 typedef struct s_bddGbcStat
@@ -201,6 +209,9 @@ typedef struct s_bddGbcStat
    long time;
    long sumtime;
    int num;
+   int minor;
+   int freednodes;
+   long freedbytes;
 } bddGbcStat;
 
 
@@ -241,6 +252,39 @@ typedef struct s_bddCacheStat
    long unsigned int swapCount;
 } bddCacheStat;
 
+
+/*
+NAME    {* bddOpCacheStat *}
+SECTION {* kernel *}
+SHORT   {* Usage statistics of one operator cache *}
+PROTO   {* typedef struct s_bddOpCacheStat
+{
+   const char *name;
+   int size;
+   long unsigned int hits;
+   long unsigned int misses;
+   int resizes;
+} bddOpCacheStat; *}
+DESCR   {* The fields are \\[\baselineskip] \begin{tabular}{ll}
+  name    & name of the cache (apply, ite, quant, appex, replace, misc) \\
+  size    & current number of entries \\
+  hits    & number of lookups answered by the cache \\
+  misses  & number of lookups not answered by the cache \\
+  resizes & number of adaptive resizes \\
+\end{tabular} *}
+ALSO    {* bdd\_opcachestats, bdd\_setmaxcachegrowth *}
+*/
+typedef struct s_bddOpCacheStat
+{
+   const char *name;
+   int size;
+   long unsigned int hits;
+   long unsigned int misses;
+   int resizes;
+} bddOpCacheStat;
+
+#define BDD_OPCACHENUM 6
+
 /*=== BDD interface prototypes =========================================*/
 
 /*
@@ -284,6 +328,7 @@ BUDDY_API int      bdd_isrunning(void) __purefn;
 BUDDY_API int      bdd_setmaxnodenum(int);
 BUDDY_API int      bdd_setmaxincrease(int);
 BUDDY_API int      bdd_setminfreenodes(int);
+BUDDY_API int      bdd_setminorgc(int);
 BUDDY_API int      bdd_getnodenum(void) __purefn;
 BUDDY_API int      bdd_getallocnum(void) __purefn;
 BUDDY_API char*    bdd_versionstr(void) __purefn;
@@ -327,10 +372,13 @@ BUDDY_API void     bdd_freepair(bddPair*);
   /* In bddop.c */
 
 BUDDY_API int      bdd_setcacheratio(int);
+BUDDY_API int      bdd_setmaxcachegrowth(int);
+BUDDY_API int      bdd_opcachestats(bddOpCacheStat *, int);
 BUDDY_API BDD      bdd_buildcube(int, int, BDD *);
 BUDDY_API BDD      bdd_ibuildcube(int, int, int *);
 BUDDY_API BDD      bdd_not(BDD);
 BUDDY_API BDD      bdd_apply(BDD, BDD, int);
+BUDDY_API int      bdd_applyarray(const BDD *, const BDD *, BDD *, int, int);
 BUDDY_API BDD      bdd_and(BDD, BDD);
 BUDDY_API BDD      bdd_or(BDD, BDD);
 BUDDY_API BDD      bdd_xor(BDD, BDD);
@@ -388,6 +436,7 @@ BUDDY_API int      bdd_fnsave(char *, BDD);
 BUDDY_API int      bdd_save(FILE *, BDD);
 BUDDY_API int      bdd_fnload(char *, BDD *);
 BUDDY_API int      bdd_load(FILE *ifile, BDD *);
+BUDDY_API int      bdd_loadarray(const int *, int, BDD *);
 
 /* In file reorder.c */
 
@@ -582,6 +631,9 @@ protected:
    friend bdd      bdd_not(const bdd &);
    friend bdd      bdd_simplify(const bdd &, const bdd &);
    friend bdd      bdd_apply(const bdd &, const bdd &, int);
+   friend int      bdd_applyarray(const bdd *, const bdd *, bdd *, int, int);
+   friend int      bdd_applyarray(const bdd *const *, const bdd *const *,
+				  bdd *, int, int);
    friend bdd      bdd_and(const bdd &, const bdd &);
    friend bdd      bdd_or(const bdd &, const bdd &);
    friend bdd      bdd_xor(const bdd &, const bdd &);
@@ -634,6 +686,7 @@ protected:
    friend int    bdd_save(FILE*, const bdd &);
    friend int    bdd_fnload(char*, bdd &);
    friend int    bdd_load(FILE*, bdd &);
+   friend int    bdd_loadarray(const int *, int, bdd *);
 
    friend bdd    fdd_ithvarpp(int, int);
    friend bdd    fdd_ithsetpp(int);
@@ -871,6 +924,10 @@ inline void bdd_printdot(const bdd &r)
 inline void bdd_fprintdot(FILE* ofile, const bdd &r)
 { bdd_fprintdot(ofile, r.root); }
 
+BUDDY_API int bdd_applyarray(const bdd *, const bdd *, bdd *, int, int);
+BUDDY_API int bdd_applyarray(const bdd *const *, const bdd *const *, bdd *,
+			     int, int);
+
 inline int bdd_fnprintdot(char* fname, const bdd &r)
 { return bdd_fnprintdot(fname, r.root); }
 
@@ -886,6 +943,8 @@ inline int bdd_fnload(char *fname, bdd &r)
 inline int bdd_load(FILE *ifile, bdd &r)
 { int lr,e; e=bdd_load(ifile, &lr); r=bdd(lr); return e; }
 
+BUDDY_API int bdd_loadarray(const int *, int, bdd *);
+
 inline int bdd_addvarblock(const bdd &v, int f)
 { return bdd_addvarblock(v.root, f); }
 
@@ -44,6 +44,10 @@
 /*************************************************************************
 *************************************************************************/
 
+/* Minimal hit rate (in percent) a cache should have to be enlarged. */
+#define CACHE_MINHIT 30
+
+
 void BddCache_reset(BddCache *cache)
 {
   int n;
@@ -52,12 +56,15 @@ void BddCache_reset(BddCache *cache)
 }
 
 
-int BddCache_init(BddCache *cache, int size)
+static int BddCache_alloc(BddCache *cache, int size)
 {
+   if (size > CACHE_MAXSIZE)
+      size = CACHE_MAXSIZE;
    size = bdd_nextpower(size);
 
    if ((cache->table=NEW(BddCacheData,size)) == NULL)
       return bdd_error(BDD_MEMORY);
+   bdd_hugepages(cache->table, sizeof(BddCacheData)*size);
 
    cache->tablesize = size;
    BddCache_reset(cache);
@@ -65,6 +72,17 @@ int BddCache_init(BddCache *cache, int size)
 }
 
 
+int BddCache_init(BddCache *cache, int size)
+{
+   cache->shift = 0;
+   cache->name = NULL;
+   cache->hits = cache->misses = 0;
+   cache->lasthits = cache->lastmisses = 0;
+   cache->resizes = 0;
+   return BddCache_alloc(cache, size);
+}
+
+
 void BddCache_done(BddCache *cache)
 {
    free(cache->table);
@@ -76,7 +94,50 @@ void BddCache_done(BddCache *cache)
 int BddCache_resize(BddCache *cache, int newsize)
 {
    free(cache->table);
-   return BddCache_init(cache, newsize);
+   return BddCache_alloc(cache, newsize);
+}
+
+
+/* Decide whether the cache should be enlarged or shrunk, based on the
+   hits and misses observed since the last call.  The size of the
+   cache will always be nominal*2^k for some k in [0,maxshift].  This
+   is meant to be called after each garbage collection, once no
+   operation holds a pointer to a cache entry.  Return 1 if the cache
+   was resized (and therefore emptied), 0 if it was left untouched,
+   and a negative error code otherwise. */
+int BddCache_adapt(BddCache *cache, int nominal, int maxshift)
+{
+   long unsigned int hits = cache->hits - cache->lasthits;
+   long unsigned int misses = cache->misses - cache->lastmisses;
+   long unsigned int lookups = hits + misses;
+   int shift = cache->shift;
+
+   cache->lasthits = cache->hits;
+   cache->lastmisses = cache->misses;
+
+   /* A cache that has been filled since the last collection and
+      that still answers a good share of the lookups is likely to
+      benefit from holding more entries. */
+   if (misses >= (long unsigned int)cache->tablesize
+       && hits * 100 >= lookups * CACHE_MINHIT)
+      ++shift;
+   /* A cache that was barely used can give some memory back. */
+   else if (lookups < (long unsigned int)(cache->tablesize / 8))
+      --shift;
+
+   if (shift > maxshift)
+      shift = maxshift;
+   if (shift < 0)
+      shift = 0;
+
+   if (shift == cache->shift)
+      return 0;
+
+   cache->shift = shift;
+   cache->resizes++;
+   if (BddCache_resize(cache, CACHE_SHIFTSIZE(nominal, shift)) < 0)
+      return BDD_MEMORY;
+   return 1;
 }
 
 
@@ -58,16 +58,39 @@ typedef struct
 {
    BddCacheData *table;
    int tablesize;               /* a power of 2 */
+   int shift;                   /* log2(tablesize/nominal size) */
+   const char *name;            /* name used in statistics */
+   long unsigned int hits;      /* number of hits since creation */
+   long unsigned int misses;    /* number of misses since creation */
+   long unsigned int lasthits;  /* value of hits at the last adaptation */
+   long unsigned int lastmisses;/* value of misses at the last adaptation */
+   int resizes;                 /* number of adaptive resizes */
 } BddCache;
 
 
+   /* Size of a cache 2^shift times larger than nominal, without
+      overflowing the largest size a cache can have. */
+#define CACHE_MAXSIZE MAXHASHSIZE
+#define CACHE_SHIFTSIZE(nominal, shift) \
+   ((nominal) > (CACHE_MAXSIZE >> (shift)) ? \
+    CACHE_MAXSIZE : (nominal) << (shift))
+
 extern int  BddCache_init(BddCache *, int);
 extern void BddCache_done(BddCache *);
 extern int  BddCache_resize(BddCache *, int);
 extern void BddCache_reset(BddCache *);
+extern int  BddCache_adapt(BddCache *, int, int);
 
 #define BddCache_lookup(cache, hash) (&(cache)->table[hash & ((cache)->tablesize - 1)])
 
+#ifdef CACHESTATS
+#define BddCache_hit(cache)  ((cache)->hits++, bddcachestats.opHit++)
+#define BddCache_miss(cache) ((cache)->misses++, bddcachestats.opMiss++)
+#else
+#define BddCache_hit(cache)  ((cache)->hits++)
+#define BddCache_miss(cache) ((cache)->misses++)
+#endif
+
 
 #endif /* _CACHE_H */
 
@@ -67,8 +67,8 @@ static void bdd_printdot_rec(ostream&, int);
 static void fdd_printset_rec(ostream &, int, int *);
 
 
-static bddstrmhandler strmhandler_bdd;
-static bddstrmhandler strmhandler_fdd;
+static BDD_TLS bddstrmhandler strmhandler_bdd;
+static BDD_TLS bddstrmhandler strmhandler_fdd;
 
    // Avoid calling C++ version of anodecount
 #undef bdd_anodecount
@@ -143,6 +143,95 @@ int bdd_anodecountpp(const bdd *r, int num)
 }
 
 
+int bdd_applyarray(const bdd *l, const bdd *r, bdd *res, int num, int op)
+{
+   // Work by chunks, so that no allocation is needed.  The previous
+   // values of res[] are only released once the new ones have been
+   // computed, because res may be the same array as l or r.
+   const int chunk = 64;
+   BDD lr[chunk], rr[chunk], tmp[chunk];
+
+   for (int done=0 ; done<num ; done+=chunk)
+   {
+      int sz = num - done < chunk ? num - done : chunk;
+      for (int n=0 ; n<sz ; n++)
+      {
+	 lr[n] = l[done+n].root;
+	 rr[n] = r[done+n].root;
+      }
+      int e = bdd_applyarray(lr, rr, tmp, sz, op);
+      if (e != 0)
+	 return e;
+      for (int n=0 ; n<sz ; n++)
+      {
+	 // tmp[n] is already referenced.
+	 BDD old = res[done+n].root;
+	 res[done+n].root = tmp[n];
+	 if (old > 1)
+	    bdd_delref(old);
+      }
+   }
+
+   return 0;
+}
+
+
+int bdd_applyarray(const bdd *const *l, const bdd *const *r, bdd *res,
+		   int num, int op)
+{
+   // Same as above, except that the operands are gathered through
+   // pointers, so that callers need not copy them (and update their
+   // reference counts) into contiguous arrays.
+   const int chunk = 64;
+   BDD lr[chunk], rr[chunk], tmp[chunk];
+
+   for (int done=0 ; done<num ; done+=chunk)
+   {
+      int sz = num - done < chunk ? num - done : chunk;
+      for (int n=0 ; n<sz ; n++)
+      {
+	 lr[n] = l[done+n]->root;
+	 rr[n] = r[done+n]->root;
+      }
+      int e = bdd_applyarray(lr, rr, tmp, sz, op);
+      if (e != 0)
+	 return e;
+      for (int n=0 ; n<sz ; n++)
+      {
+	 BDD old = res[done+n].root;
+	 res[done+n].root = tmp[n];
+	 if (old > 1)
+	    bdd_delref(old);
+      }
+   }
+
+   return 0;
+}
+
+int bdd_loadarray(const int *nodes, int nodenum, bdd *res)
+{
+   BDD *tmp;
+   int e, n;
+
+   if (nodenum <= 0)
+      return bdd_loadarray(nodes, nodenum, (BDD*)NULL);
+   if ((tmp=NEW(BDD,nodenum)) == NULL)
+      return bdd_error(BDD_MEMORY);
+
+   e = bdd_loadarray(nodes, nodenum, tmp);
+   if (e == 0)
+      for (n=0 ; n<nodenum ; n++)
+      {
+	 res[n] = bdd(tmp[n]);
+	 bdd_delref(tmp[n]);
+      }
+
+   free(tmp);
+
+   return e;
+}
+
+
 /*************************************************************************
   C++ iostream operators
 *************************************************************************/
@@ -61,12 +61,12 @@ typedef struct s_Domain
 static void Domain_allocate(Domain*, int);
 static void Domain_done(Domain*);
 
-static int    firstbddvar;
-static int    fdvaralloc;         /* Number of allocated domains */
-static int    fdvarnum;           /* Number of defined domains */
-static Domain *domain;            /* Table of domain sizes */
+static BDD_TLS int    firstbddvar;
+static BDD_TLS int    fdvaralloc;         /* Number of allocated domains */
+static BDD_TLS int    fdvarnum;           /* Number of defined domains */
+static BDD_TLS Domain *domain;            /* Table of domain sizes */
 
-static bddfilehandler filehandler;
+static BDD_TLS bddfilehandler filehandler;
 
 /*************************************************************************
   Domain definition
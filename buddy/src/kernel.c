@@ -43,6 +43,9 @@
 #include <math.h>
 #include <time.h>
 #include <assert.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 #include "kernel.h"
 #include "cache.h"
@@ -79,43 +82,58 @@ const BDD bddfalse=0;                    /* The constant false bdd */
 
 /* Min. number of nodes (%) that has to be left after a garbage collect
    unless a resize should be done. */
-static int minfreenodes=20;
+static BDD_TLS int minfreenodes=20;
+
+   /* Percentage of free nodes in the node table.  (bddfreenum*100
+      would overflow on tables of more than 20 million nodes.) */
+#define FREEPERCENT() ((int)((bddfreenum*100.0) / bddnodesize))
+
+   /* Whether to try a minor garbage collection before a full one */
+static BDD_TLS int minorgc=1;
+
+   /* Bit map of the nodes created since the last garbage collection */
+#define YOUNGWORDS(n) ((int)(((unsigned)(n)+31) >> 5))
+#define ISYOUNG(n)    (bddyoung[(n) >> 5] & (1u << ((n) & 31)))
+#define SETYOUNG(n)   (bddyoung[(n) >> 5] |= (1u << ((n) & 31)))
 
 
 /*=== GLOBAL KERNEL VARIABLES ==========================================*/
 
-int          bddrunning;            /* Flag - package initialized */
-int          bdderrorcond;          /* Some error condition */
-int          bddnodesize;           /* Number of allocated nodes */
-int          bddmaxnodesize;        /* Maximum allowed number of nodes */
-int          bddmaxnodeincrease;    /* Max. # of nodes used to inc. table */
-BddNode*     bddnodes;          /* All of the bdd nodes */
-int*         bddhash;           /* Unicity hash table */
-int          bddfreepos;        /* First free node */
-int          bddfreenum;        /* Number of free nodes */
-long int     bddproduced;       /* Number of new nodes ever produced */
-int          bddvarnum;         /* Number of defined BDD variables */
-int*         bddrefstack;       /* Internal node reference stack */
-int*         bddrefstacktop;    /* Internal node reference stack top */
-int*         bddvar2level;      /* Variable -> level table */
-int*         bddlevel2var;      /* Level -> variable table */
-jmp_buf      bddexception;      /* Long-jump point for interrupting calc. */
-int          bddresized;        /* Flag indicating a resize of the nodetable */
-int          bddcachesize;      /* Size of the operator caches */
-int          bddhashsize;       /* Size of the BDD node hash */
-
-bddCacheStat bddcachestats;
+BDD_TLS int          bddrunning;         /* Flag - package initialized */
+BDD_TLS int          bdderrorcond;       /* Some error condition */
+BDD_TLS int          bddnodesize;        /* Number of allocated nodes */
+BDD_TLS int          bddmaxnodesize;     /* Maximum allowed number of nodes */
+BDD_TLS int          bddmaxnodeincrease; /* Max. # of nodes used to inc. table */
+BDD_TLS BddNode*     bddnodes;           /* All of the bdd nodes */
+BDD_TLS int*         bddhash;            /* Unicity hash table */
+BDD_TLS int          bddfreepos;         /* First free node */
+BDD_TLS int          bddfreenum;         /* Number of free nodes */
+BDD_TLS long int     bddproduced;        /* Number of new nodes ever produced */
+BDD_TLS int          bddvarnum;          /* Number of defined BDD variables */
+BDD_TLS int*         bddrefstack;        /* Internal node reference stack */
+BDD_TLS int*         bddrefstacktop;     /* Internal node reference stack top */
+BDD_TLS int*         bddvar2level;       /* Variable -> level table */
+BDD_TLS int*         bddlevel2var;       /* Level -> variable table */
+BDD_TLS jmp_buf      bddexception;       /* Long-jump point for interrupting calc. */
+BDD_TLS int          bddresized;         /* Flag indicating a resize of the nodetable */
+BDD_TLS int          bddcachesize;       /* Size of the operator caches */
+BDD_TLS int          bddhashsize;        /* Size of the BDD node hash */
+
+BDD_TLS bddCacheStat bddcachestats;
 
 
 /*=== PRIVATE KERNEL VARIABLES =========================================*/
 
-static BDD*     bddvarset;             /* Set of defined BDD variables */
-static int      gbcollectnum;          /* Number of garbage collections */
-static long int gbcclock;              /* Clock ticks used in GBC */
-static int      usednodes_nextreorder; /* When to do reorder next time */
-static bddinthandler  err_handler;     /* Error handler */
-static bddgbchandler  gbc_handler;     /* Garbage collection handler */
-static bdd2inthandler resize_handler;  /* Node-table-resize handler */
+static BDD_TLS BDD*     bddvarset;             /* Set of defined BDD variables */
+static BDD_TLS int      gbcollectnum;          /* Number of garbage collections */
+static BDD_TLS unsigned int* bddyoung;         /* Nodes created since the last GBC */
+static BDD_TLS int      bddyoungnum;           /* Number of such nodes */
+static BDD_TLS int      minorfailed;           /* Last minor GBC freed too little */
+static BDD_TLS long int gbcclock;              /* Clock ticks used in GBC */
+static BDD_TLS int      usednodes_nextreorder; /* When to do reorder next time */
+static BDD_TLS bddinthandler  err_handler;     /* Error handler */
+static BDD_TLS bddgbchandler  gbc_handler;     /* Garbage collection handler */
+static BDD_TLS bdd2inthandler resize_handler;  /* Node-table-resize handler */
 
 
    /* Strings for all error mesages */
@@ -179,18 +197,33 @@ int bdd_init(int initnodesize, int cs)
 
    if (bddrunning)
       return bdd_error(BDD_RUNNING);
+   if (initnodesize < 2)
+      return bdd_error(BDD_RANGE);
 
    bddnodesize = initnodesize;
 
    if ((bddnodes=(BddNode*)malloc(sizeof(BddNode)*bddnodesize)) == NULL)
       return bdd_error(BDD_MEMORY);
+   bdd_hugepages(bddnodes, sizeof(BddNode)*bddnodesize);
 
-   bddhashsize = bdd_nextpower(bddnodesize);
+   bddhashsize = bddnodesize > MAXHASHSIZE ?
+      MAXHASHSIZE : (int)bdd_nextpower(bddnodesize);
    if ((bddhash=(int*)calloc(bddhashsize, sizeof(*bddhash))) == NULL)
      {
        free(bddnodes);
        return bdd_error(BDD_MEMORY);
      }
+   bdd_hugepages(bddhash, sizeof(*bddhash)*bddhashsize);
+
+   if ((bddyoung=(unsigned int*)calloc(YOUNGWORDS(bddnodesize),
+				       sizeof(*bddyoung))) == NULL)
+     {
+       free(bddhash);
+       free(bddnodes);
+       return bdd_error(BDD_MEMORY);
+     }
+   bddyoungnum = 0;
+   minorfailed = 0;
 
    bddresized = 0;
 
@@ -272,12 +305,14 @@ void bdd_done(void)
    bdd_pairs_done();
 
    free(bddnodes);
+   free(bddyoung);
    free(bddrefstack);
    free(bddvarset);
    free(bddvar2level);
    free(bddlevel2var);
 
    bddnodes = NULL;
+   bddyoung = NULL;
    bddrefstack = NULL;
    bddvarset = NULL;
 
@@ -638,6 +673,37 @@ int bdd_setminfreenodes(int mf)
 }
 
 
+/*
+NAME    {* bdd\_setminorgc *}
+SECTION {* kernel *}
+SHORT   {* enable or disable minor garbage collections *}
+PROTO   {* int bdd_setminorgc(int enable) *}
+DESCR   {* When the node table runs out of free nodes, the package first
+	   tries a {\em minor} garbage collection that only considers
+	   the nodes created since the previous garbage collection.
+	   Because a node can only point to nodes that are older than
+	   itself, such a collection does not have to visit the rest of
+	   the node table, and is therefore much shorter than a full
+	   collection when most of the table is made of long-lived nodes.
+	   Nodes that survive a minor collection are only reclaimed by
+	   the next full collection, which is done whenever a minor
+	   collection did not free enough nodes to avoid a resize (see
+	   {\tt bdd\_setminfreenodes}).  Explicit calls to
+	   {\tt bdd\_gbc} always do a full collection.
+
+	   Minor collections are enabled by default; a zero value for
+	   {\tt enable} disables them. *}
+RETURN  {* The previous setting *}
+ALSO    {* bdd\_gbc, bdd\_gbc\_hook, bdd\_setminfreenodes *}
+*/
+int bdd_setminorgc(int enable)
+{
+   int old = minorgc;
+   minorgc = enable != 0;
+   return old;
+}
+
+
 /*
 NAME    {* bdd\_getnodenum *}
 SECTION {* kernel *}
@@ -799,6 +865,23 @@ void bdd_fprintstat(FILE *ofile)
 	   (s.opHit+s.opMiss > 0) ?
 	   ((float)s.opHit)/((float)s.opHit+s.opMiss) : 0);
    fprintf(ofile, "Swap count =    %lu\n", s.swapCount);
+
+   {
+      bddOpCacheStat os[BDD_OPCACHENUM];
+      int n = bdd_opcachestats(os, BDD_OPCACHENUM);
+      int i;
+
+      fprintf(ofile, "\nOperator caches\n");
+      fprintf(ofile, "---------------\n");
+      fprintf(ofile, "%-8s %10s %14s %14s %6s %8s\n",
+	      "Cache", "Size", "Hits", "Misses", "Rate", "Resizes");
+      for (i = 0; i < n; ++i)
+	 fprintf(ofile, "%-8s %10d %14lu %14lu %6.2f %8d\n",
+		 os[i].name, os[i].size, os[i].hits, os[i].misses,
+		 (os[i].hits+os[i].misses > 0) ?
+		 ((float)os[i].hits)/((float)os[i].hits+os[i].misses) : 0,
+		 os[i].resizes);
+   }
 }
 
 
@@ -1019,8 +1102,9 @@ void bdd_default_gbchandler(int pre, bddGbcStat *s)
 {
    if (!pre)
    {
-      fprintf(stderr, "Garbage collection #%d: %d nodes / %d free",
-	     s->num, s->nodes, s->freenodes);
+      fprintf(stderr, "Garbage collection #%d%s: %d nodes / %d free"
+	      " / %d freed", s->num, s->minor ? " (minor)" : "",
+	      s->nodes, s->freenodes, s->freednodes);
       fprintf(stderr, " / %.1fs / %.1fs total\n",
 	     (float)s->time/(float)(CLOCKS_PER_SEC),
 	     (float)s->sumtime/(float)CLOCKS_PER_SEC);
@@ -1057,22 +1141,30 @@ static void bdd_gbc_rehash(void)
 }
 
 
+static void bdd_gbc_report(int pre, int minor, int freed, long int time)
+{
+   bddGbcStat s;
+   s.nodes = bddnodesize;
+   s.freenodes = bddfreenum;
+   s.time = time;
+   s.sumtime = gbcclock;
+   s.num = gbcollectnum;
+   s.minor = minor;
+   s.freednodes = freed;
+   s.freedbytes = (long int)freed * sizeof(BddNode);
+   gbc_handler(pre, &s);
+}
+
+
 void bdd_gbc(void)
 {
    int *r;
    int n;
+   int oldfreenum = bddfreenum;
    long int c2, c1 = clock();
 
    if (gbc_handler != NULL)
-   {
-      bddGbcStat s;
-      s.nodes = bddnodesize;
-      s.freenodes = bddfreenum;
-      s.time = 0;
-      s.sumtime = gbcclock;
-      s.num = gbcollectnum;
-      gbc_handler(1, &s);
-   }
+      bdd_gbc_report(1, 0, 0, 0);
 
    for (r=bddrefstack ; r<bddrefstacktop ; r++)
       bdd_mark(*r);
@@ -1084,6 +1176,8 @@ void bdd_gbc(void)
    }
 
    memset(bddhash, 0, bddhashsize*sizeof(*bddhash));
+   memset(bddyoung, 0, YOUNGWORDS(bddnodesize)*sizeof(*bddyoung));
+   bddyoungnum = 0;
 
    bddfreepos = 0;
    bddfreenum = 0;
@@ -1110,22 +1204,107 @@ void bdd_gbc(void)
       }
    }
 
-   bdd_operator_reset();
+   bdd_operator_gbc();
 
    c2 = clock();
    gbcclock += c2-c1;
    gbcollectnum++;
 
    if (gbc_handler != NULL)
+      bdd_gbc_report(0, 0, bddfreenum - oldfreenum, c2-c1);
+}
+
+
+/* Mark the young nodes reachable from i.  Old nodes cannot point to
+   young nodes, so there is no need to look below them. */
+static void bdd_mark_young(int i)
+{
+   BddNode *node;
+
+   if (__unlikely(i < 2)  ||  !ISYOUNG(i))
+      return;
+
+   node = &bddnodes[i];
+   if (LEVELp(node) & MARKON  ||  LOWp(node) == -1)
+      return;
+
+   LEVELp(node) |= MARKON;
+
+   bdd_mark_young(LOWp(node));
+   bdd_mark_young(HIGHp(node));
+}
+
+
+/* Minor garbage collection: reclaim the dead nodes among those created
+   since the last collection, and promote the others.  Old dead nodes
+   are left for the next full collection. */
+static void bdd_gbc_minor(void)
+{
+   int *r;
+   int w, words = YOUNGWORDS(bddnodesize);
+   int freed = 0;
+   long int c2, c1 = clock();
+
+   if (gbc_handler != NULL)
+      bdd_gbc_report(1, 1, 0, 0);
+
+   for (r=bddrefstack ; r<bddrefstacktop ; r++)
+      bdd_mark_young(*r);
+
+   for (w=0 ; w<words ; w++)
    {
-      bddGbcStat s;
-      s.nodes = bddnodesize;
-      s.freenodes = bddfreenum;
-      s.time = c2-c1;
-      s.sumtime = gbcclock;
-      s.num = gbcollectnum;
-      gbc_handler(0, &s);
+      unsigned int bits = bddyoung[w];
+      while (bits)
+      {
+	 int n = (w << 5) + __builtin_ctz(bits);
+	 bits &= bits - 1;
+	 if (bddnodes[n].refcou > 0)
+	    bdd_mark_young(n);
+      }
    }
+
+   for (w=0 ; w<words ; w++)
+   {
+      unsigned int bits = bddyoung[w];
+      bddyoung[w] = 0;
+      while (bits)
+      {
+	 int n = (w << 5) + __builtin_ctz(bits);
+	 register BddNode *node = &bddnodes[n];
+	 bits &= bits - 1;
+
+	 if (LOWp(node) == -1)
+	    continue;
+
+	 if (LEVELp(node) & MARKON)
+	    LEVELp(node) &= MARKOFF;
+	 else
+	 {
+	    /* Unlink the node from its hash chain, and free it. */
+	    int *p = &bddhash[NODEHASH(LEVELp(node), LOWp(node),
+				       HIGHp(node))];
+	    while (*p != n)
+	       p = &bddnodes[*p].next;
+	    *p = node->next;
+
+	    LOWp(node) = -1;
+	    node->next = bddfreepos;
+	    bddfreepos = n;
+	    bddfreenum++;
+	    freed++;
+	 }
+      }
+   }
+   bddyoungnum = 0;
+
+   bdd_operator_gbc();
+
+   c2 = clock();
+   gbcclock += c2-c1;
+   gbcollectnum++;
+
+   if (gbc_handler != NULL)
+      bdd_gbc_report(0, 1, freed, c2-c1);
 }
 
 
@@ -1369,8 +1548,24 @@ int bdd_makenode(unsigned int level, int low, int high)
       if (bdderrorcond)
 	 return 0;
 
-	 /* Try to allocate more nodes */
-      bdd_gbc();
+	 /* Try to allocate more nodes.  A minor collection is enough
+	    if it frees as many nodes as we would like to have after a
+	    full one, and does not delay a reordering.  If it was not
+	    enough the last time, go straight to a full collection. */
+      if (minorgc  &&  !minorfailed  &&  bddyoungnum > 0)
+      {
+	 bdd_gbc_minor();
+	 minorfailed = FREEPERCENT() <= minfreenodes  ||
+	    ((bddnodesize-bddfreenum) >= usednodes_nextreorder  &&
+	     bdd_reorder_ready());
+	 if (minorfailed)
+	    bdd_gbc();
+      }
+      else
+      {
+	 bdd_gbc();
+	 minorfailed = 0;
+      }
 
       if ((bddnodesize-bddfreenum) >= usednodes_nextreorder  &&
 	   bdd_reorder_ready())
@@ -1378,7 +1573,7 @@ int bdd_makenode(unsigned int level, int low, int high)
 	 longjmp(bddexception,1);
       }
 
-      if ((bddfreenum*100) / bddnodesize <= minfreenodes)
+      if (FREEPERCENT() <= minfreenodes)
       {
 	 bdd_noderesize(1);
 	 hash = NODEHASH(level, low, high);
@@ -1398,6 +1593,8 @@ int bdd_makenode(unsigned int level, int low, int high)
    bddfreepos = bddnodes[bddfreepos].next;
    bddfreenum--;
    bddproduced++;
+   SETYOUNG(res);
+   bddyoungnum++;
 
    node = &bddnodes[res];
    LEVELp(node) = level;
@@ -1412,6 +1609,26 @@ int bdd_makenode(unsigned int level, int low, int high)
 }
 
 
+/* The node table, the hash table and the operator caches are accessed
+   at random, so on large tables most of these accesses also miss the
+   TLB.  Ask the system to back them with transparent huge pages.
+   Only the part of [p,p+size) aligned on huge pages can benefit. */
+void bdd_hugepages(void *p, size_t size)
+{
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+   const size_t huge = (size_t)2 << 20;
+   size_t begin = ((size_t)p + huge - 1) & ~(huge - 1);
+   size_t end = ((size_t)p + size) & ~(huge - 1);
+
+   if (begin < end)
+      madvise((void*)begin, end - begin, MADV_HUGEPAGE);
+#else
+   (void)p;
+   (void)size;
+#endif
+}
+
+
 int bdd_noderesize(int doRehash)
 {
    BddNode *newnodes;
@@ -1421,10 +1638,17 @@ int bdd_noderesize(int doRehash)
 
    if (bddnodesize >= bddmaxnodesize  &&  bddmaxnodesize > 0)
       return -1;
+   if (bddnodesize >= MAXNODENUM)
+      return -1;
 
-   bddnodesize <<= 1;
+      /* Double the size, but do not add more than bddmaxnodeincrease
+	 nodes, and do not overflow the node indices. */
+   if (bddnodesize > MAXNODENUM - bddnodesize)
+      bddnodesize = MAXNODENUM;
+   else
+      bddnodesize <<= 1;
 
-   if (bddnodesize > oldsize + bddmaxnodeincrease)
+   if (bddnodesize - oldsize > bddmaxnodeincrease)
       bddnodesize = oldsize + bddmaxnodeincrease;
 
    if (bddnodesize > bddmaxnodesize  &&  bddmaxnodesize > 0)
@@ -1437,8 +1661,20 @@ int bdd_noderesize(int doRehash)
    if (newnodes == NULL)
       return bdd_error(BDD_MEMORY);
    bddnodes = newnodes;
+   bdd_hugepages(bddnodes, sizeof(BddNode)*bddnodesize);
+
+   {
+     int oldwords = YOUNGWORDS(oldsize);
+     int newwords = YOUNGWORDS(bddnodesize);
+     unsigned int *newyoung =
+       (unsigned int*)realloc(bddyoung, sizeof(*bddyoung)*newwords);
+     if (newyoung == NULL)
+       return bdd_error(BDD_MEMORY);
+     bddyoung = newyoung;
+     memset(bddyoung + oldwords, 0, (newwords-oldwords)*sizeof(*bddyoung));
+   }
 
-   if (oldhashsize * 2 <= bddnodesize)
+   if (oldhashsize <= bddnodesize / 2)
      bddhashsize <<= 1;
 
    if (doRehash)
@@ -47,6 +47,25 @@
 # include "config.h"
 #endif
 
+/*=== THREAD-LOCAL STATE ===============================================*/
+
+/* When BUDDY_THREAD_LOCAL is defined (configure --enable-pthread),
+   every variable that is part of the state of the package is
+   thread-local, so that each thread has its own independent instance
+   of the package, initialized by its own call to bdd_init().  BDDs
+   must then never be passed from one thread to another.  The default
+   TLS model is used, so that the shared library can be loaded with
+   dlopen() (e.g., by the Python bindings): with the initial-exec
+   model, its whole TLS block would have to fit in the small static
+   TLS area that the dynamic loader reserves for such libraries.
+   configure compiles BuDDy with TLS descriptors (-mtls-dialect=gnu2)
+   when possible, to reduce the cost of each access. */
+#ifdef BUDDY_THREAD_LOCAL
+# define BDD_TLS __thread
+#else
+# define BDD_TLS
+#endif
+
 /*=== SANITY CHECKS ====================================================*/
 
    /* Make sure we use at least 32 bit integers */
@@ -115,27 +134,27 @@ typedef struct s_BddNodeInit
 extern "C" {
 #endif
 
-extern int       bddrunning;         /* Flag - package initialized */
-extern int       bdderrorcond;       /* Some error condition was met */
-extern int       bddnodesize;        /* Number of allocated nodes */
-extern int       bddhashsize;        /* Size of node hash tableq */
-extern int       bddmaxnodesize;     /* Maximum allowed number of nodes */
-extern int       bddmaxnodeincrease; /* Max. # of nodes used to inc. table */
-extern BddNode*  bddnodes;           /* All of the bdd nodes */
-extern int*      bddhash;            /* Unicity hash table */
-extern int       bddvarnum;          /* Number of defined BDD variables */
-extern int*      bddrefstack;        /* Internal node reference stack */
-extern int*      bddrefstacktop;     /* Internal node reference stack top */
-extern int*      bddvar2level;
-extern int*      bddlevel2var;
-extern jmp_buf   bddexception;
-extern int       bddreorderdisabled;
-extern int       bddresized;
-extern int       bddcachesize;
-extern bddCacheStat bddcachestats;
+extern BDD_TLS int       bddrunning;         /* Flag - package initialized */
+extern BDD_TLS int       bdderrorcond;       /* Some error condition was met */
+extern BDD_TLS int       bddnodesize;        /* Number of allocated nodes */
+extern BDD_TLS int       bddhashsize;        /* Size of node hash tableq */
+extern BDD_TLS int       bddmaxnodesize;     /* Maximum allowed number of nodes */
+extern BDD_TLS int       bddmaxnodeincrease; /* Max. # of nodes used to inc. table */
+extern BDD_TLS BddNode*  bddnodes;           /* All of the bdd nodes */
+extern BDD_TLS int*      bddhash;            /* Unicity hash table */
+extern BDD_TLS int       bddvarnum;          /* Number of defined BDD variables */
+extern BDD_TLS int*      bddrefstack;        /* Internal node reference stack */
+extern BDD_TLS int*      bddrefstacktop;     /* Internal node reference stack top */
+extern BDD_TLS int*      bddvar2level;
+extern BDD_TLS int*      bddlevel2var;
+extern BDD_TLS jmp_buf   bddexception;
+extern BDD_TLS int       bddreorderdisabled;
+extern BDD_TLS int       bddresized;
+extern BDD_TLS int       bddcachesize;
+extern BDD_TLS bddCacheStat bddcachestats;
 
   /* from reorder.c */
-extern int bddreordermethod;
+extern BDD_TLS int bddreordermethod;
 
 #ifdef CPLUSPLUS
 }
@@ -228,6 +247,11 @@ static inline int PUSHREF(int a)
 
 #define DEFAULTMAXNODEINC 50000
 
+   /* Node indices are stored in ints, and -1 marks free nodes. */
+#define MAXNODENUM INT_MAX
+   /* Largest power of two that fits in an int, for hash tables. */
+#define MAXHASHSIZE (1 << 30)
+
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
 #define NEW(t,n) ( (t*)malloc(sizeof(t)*(n)) )
@@ -255,6 +279,7 @@ extern int    bdd_operator_init(int);
 extern void   bdd_operator_done(void);
 extern void   bdd_operator_varresize(void);
 extern void   bdd_operator_reset(void);
+extern void   bdd_operator_gbc(void);
 
 extern void   bdd_pairs_init(void);
 extern void   bdd_pairs_done(void);
@@ -273,6 +298,8 @@ extern int    bdd_reorder_varup(int);
 
 extern void   bdd_cpp_init(void);
 
+extern void   bdd_hugepages(void *, size_t);
+
 #ifdef CPLUSPLUS
 }
 #endif
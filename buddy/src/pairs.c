@@ -40,8 +40,8 @@
 
 /*======================================================================*/
 
-static int      pairsid;            /* Pair identifier */
-static bddPair* pairs;              /* List of all replacement pairs in use */
+static BDD_TLS int      pairsid;            /* Pair identifier */
+static BDD_TLS bddPair* pairs;              /* List of all replacement pairs in use */
 
 
 /*************************************************************************
@@ -83,6 +83,7 @@
 #include <spot/misc/optionmap.hh>
 #include <spot/misc/random.hh>
 #include <spot/misc/escape.hh>
+#include <spot/misc/strpool.hh>
 #include <spot/misc/trival.hh>
 
 #include <spot/tl/formula.hh>
@@ -786,7 +787,20 @@ def state_is_accepting(self, src) -> "bool":
 
   std::vector<std::string>* get_state_names()
   {
-    return self->get_named_prop<std::vector<std::string>>("state-names");
+    auto* sn = self->get_named_prop<std::vector<std::string>>("state-names");
+    // Names stored in a string_pool are converted on demand.
+    auto* sp = self->get_named_prop<spot::string_pool>("state-name-pool");
+    if (!sn && sp)
+      {
+        sn = new std::vector<std::string>;
+        unsigned n = sp->size();
+        sn->reserve(n);
+        for (unsigned i = 0; i < n; ++i)
+          sn->emplace_back(sp->str(i));
+        self->set_named_prop("state-names", sn);
+        self->set_named_prop("state-name-pool", nullptr);
+      }
+    return sn;
   }
 
 
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014, 2015, 2016, 2017 Laboratoire de Recherche et
+// Copyright (C) 2014-2018 Laboratoire de Recherche et
 // Développement de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -20,11 +20,13 @@
 #pragma once
 
 #include <spot/misc/common.hh>
+#include <spot/misc/memres.hh>
 #include <vector>
 #include <type_traits>
 #include <tuple>
 #include <cassert>
 #include <iterator>
+#include <new>
 #include <algorithm>
 #include <map>
 #include <iostream>
@@ -411,6 +413,45 @@ namespace spot
       edge t_;
     };
 
+    // Fake container listing the outgoing edges of a state in a
+    // frozen graph.  These edges are consecutive in the edge vector,
+    // so this is just a range of pointers.
+
+    template <typename Graph>
+    class SPOT_API frozen_state_out
+    {
+    public:
+      typedef typename std::conditional<std::is_const<Graph>::value,
+                                        const typename Graph::edge_storage_t,
+                                        typename Graph::edge_storage_t>::type
+        value_type;
+      typedef value_type* iterator;
+
+      frozen_state_out(iterator b, iterator e) noexcept
+        : b_(b), e_(e)
+      {
+      }
+
+      iterator begin() const
+      {
+        return b_;
+      }
+
+      iterator end() const
+      {
+        return e_;
+      }
+
+      unsigned size() const
+      {
+        return e_ - b_;
+      }
+
+    protected:
+      iterator b_;
+      iterator e_;
+    };
+
     //////////////////////////////////////////////////
     // all_trans
     //////////////////////////////////////////////////
@@ -575,6 +616,72 @@ namespace spot
 
     };
 
+    // The sort key of an edge: its source, destination, an
+    // additional integer, and its original position, used to break
+    // ties.
+    struct SPOT_API edge_sort_key
+    {
+      unsigned src;
+      unsigned dst;
+      unsigned val;
+      unsigned pos;
+
+      bool operator<(const edge_sort_key& o) const
+      {
+        if (src != o.src)
+          return src < o.src;
+        if (dst != o.dst)
+          return dst < o.dst;
+        if (val != o.val)
+          return val < o.val;
+        return pos < o.pos;
+      }
+    };
+
+    // Sort keys by source, destination, and val, with an LSD radix
+    // sort.  The sort is stable, so keys that were built in
+    // increasing pos order end up sorted as by operator<.  Each
+    // field is processed 11 bits at a time, only up to its largest
+    // value, and passes where all keys share the same digit are
+    // skipped.
+    inline void radix_sort_edge_keys(std::vector<edge_sort_key>& keys)
+    {
+      size_t n = keys.size();
+      if (n < 2)
+        return;
+      unsigned edge_sort_key::* fields[3] =
+        { &edge_sort_key::val, &edge_sort_key::dst, &edge_sort_key::src };
+      unsigned max[3] = { 0, 0, 0 };
+      for (auto& k: keys)
+        for (unsigned f = 0; f < 3; ++f)
+          max[f] = std::max(max[f], k.*fields[f]);
+
+      constexpr unsigned bits = 11;
+      constexpr unsigned mask = (1U << bits) - 1;
+      std::vector<edge_sort_key> tmp(n);
+      std::vector<size_t> count(mask + 1);
+      for (unsigned f = 0; f < 3; ++f)
+        for (unsigned shift = 0; shift < 32 && (max[f] >> shift);
+             shift += bits)
+          {
+            auto field = fields[f];
+            std::fill(count.begin(), count.end(), 0);
+            for (auto& k: keys)
+              ++count[(k.*field >> shift) & mask];
+            if (count[(keys[0].*field >> shift) & mask] == n)
+              continue;
+            size_t sum = 0;
+            for (auto& c: count)
+              {
+                size_t t = c;
+                c = sum;
+                sum += t;
+              }
+            for (auto& k: keys)
+              tmp[count[(k.*field >> shift) & mask]++] = k;
+            keys.swap(tmp);
+          }
+    }
   } // namespace internal
 
 
@@ -608,12 +715,15 @@ namespace spot
     typedef internal::edge_storage<state, state, edge,
                                    internal::boxed_label<Edge_Data>>
       edge_storage_t;
-    typedef std::vector<state_storage_t> state_vector;
-    typedef std::vector<edge_storage_t> edge_vector_t;
+    typedef std::vector<state_storage_t,
+                        polymorphic_allocator<state_storage_t>> state_vector;
+    typedef std::vector<edge_storage_t,
+                        polymorphic_allocator<edge_storage_t>> edge_vector_t;
 
     // A sequence of universal destination groups of the form:
     //   (n state_1 state_2 ... state_n)*
-    typedef std::vector<unsigned> dests_vector_t;
+    typedef std::vector<unsigned,
+                        polymorphic_allocator<unsigned>> dests_vector_t;
 
   protected:
     state_vector states_;
@@ -621,6 +731,22 @@ namespace spot
     dests_vector_t dests_;      // Only used by alternating automata.
     // Number of erased edges.
     unsigned killed_edge_;
+    // Only used by frozen graphs: the outgoing edges of state s are
+    // the edges offsets_[s] to offsets_[s + 1] - 1.
+    std::vector<edge> offsets_;
+
+    template <typename V>
+    static void move_to_resource_(V& v, memory_resource* r)
+    {
+      if (*v.get_allocator().resource() == *r)
+        return;
+      // The allocator of a vector is only set on construction.
+      V tmp(std::make_move_iterator(v.begin()),
+            std::make_move_iterator(v.end()), r);
+      v.~V();
+      new (&v) V(std::move(tmp));
+    }
+
   public:
     /// \brief Construct an empty graph
     ///
@@ -628,6 +754,11 @@ namespace spot
     /// states and \a max_trans edges.  These are not hard
     /// limits, but just hints to pre-allocate a data structure that
     /// may hold that much items.
+    ///
+    /// The storage of the graph is allocated from the default
+    /// memory resource of the current thread (see
+    /// spot::get_default_resource()), and so is the storage of any
+    /// copy of this graph.
     digraph(unsigned max_states = 10, unsigned max_trans = 0)
       : killed_edge_(0)
     {
@@ -662,6 +793,24 @@ namespace spot
       return dests_.empty();
     }
 
+    /// The memory resource from which the graph is allocated.
+    memory_resource* get_memory_resource() const
+    {
+      return states_.get_allocator().resource();
+    }
+
+    /// \brief Move the storage of the graph to another resource.
+    ///
+    /// This is typically used to keep a graph built using a
+    /// short-lived memory resource.  It invalidates all iterators
+    /// and references to states and edges.
+    void set_memory_resource(memory_resource* r)
+    {
+      move_to_resource_(states_, r);
+      move_to_resource_(edges_, r);
+      move_to_resource_(dests_, r);
+    }
+
 #ifndef SWIG
     /// \brief Whether the automaton has universal branching
     ///
@@ -682,6 +831,7 @@ namespace spot
     template <typename... Args>
     state new_state(Args&&... args)
     {
+      unfreeze();
       state s = states_.size();
       states_.emplace_back(std::forward<Args>(args)...);
       return s;
@@ -696,6 +846,7 @@ namespace spot
     template <typename... Args>
     state new_states(unsigned n, Args&&... args)
     {
+      unfreeze();
       state s = states_.size();
       states_.reserve(s + n);
       while (n--)
@@ -784,6 +935,7 @@ namespace spot
     edge
     new_edge(state src, state dst, Args&&... args)
     {
+      unfreeze();
       edge t = edges_.size();
       edges_.emplace_back(dst, 0, src, std::forward<Args>(args)...);
 
@@ -915,6 +1067,7 @@ namespace spot
     internal::killer_edge_iterator<digraph>
     out_iteraser(state_storage_t& src)
     {
+      unfreeze();
       return {this, src.succ, src};
     }
 
@@ -925,6 +1078,128 @@ namespace spot
     }
     ///@}
 
+    /// @{
+    /// \brief Return a fake container with all edges leaving \a src,
+    /// in a frozen graph.
+    ///
+    /// This lists the same edges as out(), in the same order, but
+    /// iterates over them as a plain range of memory.
+    ///
+    /// \pre is_frozen()
+    internal::frozen_state_out<digraph>
+    frozen_out(state src)
+    {
+      SPOT_ASSERT(is_frozen());
+      edge_storage_t* e = edges_.data();
+      return {e + offsets_[src], e + offsets_[src + 1]};
+    }
+
+    internal::frozen_state_out<const digraph>
+    frozen_out(state src) const
+    {
+      SPOT_ASSERT(is_frozen());
+      const edge_storage_t* e = edges_.data();
+      return {e + offsets_[src], e + offsets_[src + 1]};
+    }
+    /// @}
+
+    /// \brief Store the outgoing edges of each state consecutively.
+    ///
+    /// Dead edges are removed, and the other edges are renumbered so
+    /// that the outgoing edges of each state are consecutive in the
+    /// edge vector, in the order listed by out().  An array of
+    /// offsets into the edge vector (see edge_offsets()) is built at
+    /// the same time.  out() and edges() still work on a frozen
+    /// graph, but now walk through consecutive memory, and
+    /// frozen_out() can be used to iterate over the outgoing edges of
+    /// a state without following the next_succ links.
+    ///
+    /// The graph is not made read-only: the data of states and edges
+    /// may be modified freely, but any function that adds, removes,
+    /// or renumbers states or edges unfreezes it.  Code that modifies
+    /// the edge chains via edge_vector() or states() should call
+    /// unfreeze() itself.
+    ///
+    /// Freezing a graph whose edges are already in this order (e.g.,
+    /// after chain_edges_()) only builds the offsets.
+    ///
+    /// \return true iff the edges have been renumbered.
+    bool freeze()
+    {
+      if (is_frozen())
+        return false;
+      unsigned send = states_.size();
+      offsets_.resize(send + 1);
+      // Check whether the chains already follow the edge vector.
+      edge pos = 1;
+      bool in_order = true;
+      for (state s = 0; s < send; ++s)
+        {
+          offsets_[s] = pos;
+          for (edge t = states_[s].succ; t; t = edges_[t].next_succ)
+            in_order &= t == pos++;
+        }
+      offsets_[send] = pos;
+      if (in_order)
+        {
+          // Only dead edges can follow the last live edge.
+          edges_.resize(pos);
+          killed_edge_ = 0;
+          return false;
+        }
+      edge_vector_t edges(edges_.get_allocator());
+      edges.reserve(pos);
+      edges.emplace_back(std::move(edges_[0]));
+      for (state s = 0; s < send; ++s)
+        {
+          auto& ss = states_[s];
+          edge b = edges.size();
+          for (edge t = ss.succ; t;)
+            {
+              edge next = edges_[t].next_succ;
+              edges.emplace_back(std::move(edges_[t]));
+              edges.back().next_succ = edges.size();
+              t = next;
+            }
+          edge e = edges.size();
+          if (b == e)
+            continue;
+          edges.back().next_succ = 0;
+          ss.succ = b;
+          ss.succ_tail = e - 1;
+        }
+      edges_.swap(edges);
+      killed_edge_ = 0;
+      return true;
+    }
+
+    /// \brief Forget the layout computed by freeze().
+    ///
+    /// The edges are not moved, this only releases the offsets.
+    void unfreeze()
+    {
+      offsets_.clear();
+    }
+
+    /// \brief Whether freeze() has been called since the last
+    /// modification of the structure of the graph.
+    bool is_frozen() const
+    {
+      return !offsets_.empty();
+    }
+
+    /// \brief The offsets of the outgoing edges of each state in a
+    /// frozen graph.
+    ///
+    /// The outgoing edges of state s are the edges numbered from
+    /// edge_offsets()[s] to edge_offsets()[s + 1] - 1 in
+    /// edge_vector().  This vector is empty if the graph is not
+    /// frozen.
+    const std::vector<edge>& edge_offsets() const
+    {
+      return offsets_;
+    }
+
     /// @{
     ///
     /// \brief Return the vector of states.
@@ -1068,6 +1343,7 @@ namespace spot
     {
       if (killed_edge_ == 0)
         return;
+      unfreeze();
       auto i = std::remove_if(edges_.begin() + 1, edges_.end(),
                               [this](const edge_storage_t& t) {
                                 return this->is_dead_edge(t);
@@ -1084,17 +1360,54 @@ namespace spot
     template<class Predicate = std::less<edge_storage_t>>
     void sort_edges_(Predicate p = Predicate())
     {
+      unfreeze();
       //std::cerr << "\nbefore\n";
       //dump_storage(std::cerr);
       std::stable_sort(edges_.begin() + 1, edges_.end(), p);
     }
 
+    /// \brief Sort all edges by source, destination, and an integer
+    ///
+    /// This has the same effect as calling sort_edges_() with a
+    /// predicate that compares the sources, then the destinations,
+    /// and finally the values of \a val, but it is implemented as a
+    /// radix sort on these three integers, and moves each edge only
+    /// once.  The sort is stable.
+    ///
+    /// As for sort_edges_(), call chain_edges_() afterwards.
+    ///
+    /// \param val a function returning an unsigned integer for an
+    /// edge_storage_t.
+    template<class Val>
+    void radix_sort_edges_(Val val)
+    {
+      unfreeze();
+      unsigned tend = edges_.size();
+      if (tend < 3)
+        return;
+      std::vector<internal::edge_sort_key> keys;
+      keys.reserve(tend - 1);
+      for (unsigned t = 1; t < tend; ++t)
+        {
+          const edge_storage_t& e = edges_[t];
+          keys.push_back({e.src, e.dst, unsigned(val(e)), t});
+        }
+      internal::radix_sort_edge_keys(keys);
+      edge_vector_t sorted(edges_.get_allocator());
+      sorted.reserve(tend);
+      sorted.emplace_back(std::move(edges_[0]));
+      for (auto& k: keys)
+        sorted.emplace_back(std::move(edges_[k.pos]));
+      edges_.swap(sorted);
+    }
+
     /// \brief Reconstruct the chain of outgoing edges
     ///
     /// Should be called only when it is known that all edges
     /// with the same destination are consecutive in the vector.
     void chain_edges_()
     {
+      unfreeze();
       state last_src = -1U;
       edge tend = edges_.size();
       for (edge t = 1; t < tend; ++t)
@@ -1142,6 +1455,7 @@ namespace spot
     void rename_states_(const std::vector<unsigned>& newst)
     {
       SPOT_ASSERT(newst.size() == states_.size());
+      unfreeze();
       unsigned tend = edges_.size();
       for (unsigned t = 1; t < tend; t++)
         {
@@ -1155,10 +1469,14 @@ namespace spot
     /// \param newst A vector indicating how each state should be renumbered.
     /// Use -1U to erase a state.
     /// \param used_states the number of states used (after renumbering)
-    void defrag_states(std::vector<unsigned>&& newst, unsigned used_states)
+    /// \param ppolicy the number of threads that may be used to
+    /// renumber the edges, if there are enough of them.
+    void defrag_states(std::vector<unsigned>&& newst, unsigned used_states,
+                       parallel_policy ppolicy = parallel_policy())
     {
       SPOT_ASSERT(newst.size() >= states_.size());
       SPOT_ASSERT(used_states > 0);
+      unfreeze();
 
       //std::cerr << "\nbefore defrag\n";
       //dump_storage(std::cerr);
@@ -1189,27 +1507,35 @@ namespace spot
       // between the old and new index as newidx[old] = new.
       unsigned tend = edges_.size();
       std::vector<edge> newidx(tend);
-      unsigned dest = 1;
-      for (edge t = 1; t < tend; ++t)
+      unsigned nthreads = internal::parallel_threads(ppolicy, tend);
+      if (nthreads > 1)
         {
-          if (is_dead_edge(t))
-            continue;
-          if (t != dest)
-            edges_[dest] = std::move(edges_[t]);
-          newidx[t] = dest;
-          ++dest;
+          defrag_edges_(newst, newidx, nthreads);
         }
-      edges_.resize(dest);
-      killed_edge_ = 0;
-
-      // Adjust next_succ and dst pointers in all edges.
-      for (edge t = 1; t < dest; ++t)
+      else
         {
-          auto& tr = edges_[t];
-          tr.src = newst[tr.src];
-          tr.dst = newst[tr.dst];
-          tr.next_succ = newidx[tr.next_succ];
+          unsigned dest = 1;
+          for (edge t = 1; t < tend; ++t)
+            {
+              if (is_dead_edge(t))
+                continue;
+              if (t != dest)
+                edges_[dest] = std::move(edges_[t]);
+              newidx[t] = dest;
+              ++dest;
+            }
+          edges_.resize(dest);
+
+          // Adjust next_succ and dst pointers in all edges.
+          for (edge t = 1; t < dest; ++t)
+            {
+              auto& tr = edges_[t];
+              tr.src = newst[tr.src];
+              tr.dst = newst[tr.dst];
+              tr.next_succ = newidx[tr.next_succ];
+            }
         }
+      killed_edge_ = 0;
 
       // Adjust succ and succ_tails pointers in all states.
       for (auto& s: states_)
@@ -1221,5 +1547,63 @@ namespace spot
       //std::cerr << "\nafter defrag\n";
       //dump_storage(std::cerr);
     }
+
+  private:
+    // The edge compaction of defrag_states(), using nthreads
+    // threads.  Live edges are moved into a new vector, so worker
+    // threads only assign to default-constructed edges, and the dead
+    // edges are destroyed by the calling thread with the old vector.
+    // (For twa_graph, this ensures that worker threads never update
+    // the reference count of a BDD.)
+    void defrag_edges_(const std::vector<unsigned>& newst,
+                       std::vector<edge>& newidx, unsigned nthreads)
+    {
+      unsigned tend = edges_.size();
+      // Count the live edges of each range, and turn these counts
+      // into the first index of each range in the new vector.
+      std::vector<edge> first(nthreads + 1);
+      internal::parallel_ranges(nthreads, tend - 1,
+                                [&](unsigned i, size_t b, size_t e)
+                                {
+                                  edge n = 0;
+                                  for (edge t = b + 1; t <= e; ++t)
+                                    n += !is_dead_edge(t);
+                                  first[i + 1] = n;
+                                });
+      first[0] = 1;
+      for (unsigned i = 0; i < nthreads; ++i)
+        first[i + 1] += first[i];
+      edge dend = first[nthreads];
+
+      edge_vector_t edges(edges_.get_allocator());
+      edges.reserve(dend);
+      edges.emplace_back(std::move(edges_[0]));
+      edges.resize(dend);
+      internal::parallel_ranges(nthreads, tend - 1,
+                                [&](unsigned i, size_t b, size_t e)
+                                {
+                                  edge dest = first[i];
+                                  for (edge t = b + 1; t <= e; ++t)
+                                    if (!is_dead_edge(t))
+                                      {
+                                        newidx[t] = dest;
+                                        edges[dest++] = std::move(edges_[t]);
+                                      }
+                                });
+      // Adjust next_succ and dst pointers in all edges, now that
+      // newidx is complete.
+      internal::parallel_ranges(nthreads, dend - 1,
+                                [&](unsigned, size_t b, size_t e)
+                                {
+                                  for (edge t = b + 1; t <= e; ++t)
+                                    {
+                                      auto& tr = edges[t];
+                                      tr.src = newst[tr.src];
+                                      tr.dst = newst[tr.dst];
+                                      tr.next_succ = newidx[tr.next_succ];
+                                    }
+                                });
+      edges_.swap(edges);
+    }
   };
 }
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014, 2015, 2016 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2016, 2018 Laboratoire de Recherche et Développement
 // de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -90,6 +90,7 @@ namespace spot
           auto old = p.first->second;
           p.first->second = s;
           // Add the successor of OLD to those of S.
+          g_.unfreeze();
           auto& trans = g_.edge_vector();
           auto& states = g_.states();
           trans[states[s].succ_tail].next_succ = states[old].succ;
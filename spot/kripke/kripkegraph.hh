@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011-2017 Laboratoire de Recherche et Développement de
+// Copyright (C) 2011-2018 Laboratoire de Recherche et Développement de
 // l'Epita (LRDE)
 //
 // This file is part of Spot, a model checking library.
@@ -132,6 +132,16 @@ namespace spot
       return const_cast<kripke_graph_state*>
         (&g_->state_data(g_->edge_storage(p_).dst));
     }
+
+#ifndef SWIG
+    virtual bool fill_succ(std::vector<twa_succ_entry>& out) override
+    {
+      for (edge e = t_; e; e = g_->edge_storage(e).next_succ)
+        out.push_back({&g_->state_data(g_->edge_storage(e).dst),
+                       cond_, 0U});
+      return true;
+    }
+#endif
   };
 
 
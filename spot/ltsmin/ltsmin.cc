@@ -18,8 +18,14 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <ltdl.h>
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <sstream>
 #include <sys/stat.h>
@@ -36,6 +42,7 @@
 #include <spot/misc/mspool.hh>
 #include <spot/misc/intvcomp.hh>
 #include <spot/misc/intvcmp2.hh>
+#include <spot/priv/parallel.hh>
 
 namespace spot
 {
@@ -302,6 +309,13 @@ namespace spot
         return (*it_)->clone();
       }
 
+      virtual bool fill_succ(std::vector<twa_succ_entry>& out) override
+      {
+        for (auto t: cc_->transitions)
+          out.push_back({t->clone(), cond_, 0U});
+        return true;
+      }
+
     private:
       const callback_context* cc_;
       callback_context::transitions_t::const_iterator it_;
@@ -335,7 +349,8 @@ namespace spot
                 spins_interface_ptr d,
                 bdd_dict_ptr dict,
                 formula dead,
-                prop_set& out)
+                prop_set& out,
+                const void* owner)
     {
       int errors = 0;
       std::ostringstream err;
@@ -460,7 +475,7 @@ namespace spot
                 }
 
               // Record that X.Y must be equal to Z.
-              int v = dict->register_proposition(*ap, d.get());
+              int v = dict->register_proposition(*ap, owner);
               one_prop p = { ni->second.num, OP_EQ, ei->second, v };
               out.emplace_back(p);
               free(name);
@@ -471,7 +486,7 @@ namespace spot
 
           if (!*s)                // No operator?  Assume "!= 0".
             {
-              int v = dict->register_proposition(*ap, d);
+              int v = dict->register_proposition(*ap, owner);
               one_prop p = { var_num, OP_NE, 0, v };
               out.emplace_back(p);
               free(name);
@@ -589,7 +604,7 @@ namespace spot
             }
 
 
-          int v = dict->register_proposition(*ap, d);
+          int v = dict->register_proposition(*ap, owner);
           one_prop p = { var_num, op, val, v };
           out.emplace_back(p);
         }
@@ -598,6 +613,29 @@ namespace spot
         throw std::runtime_error(err.str());
     }
 
+    bool
+    eval_prop(const one_prop& p, const int* vars)
+    {
+      int l = vars[p.var_num];
+      int r = p.val;
+      switch (p.op)
+        {
+        case OP_EQ:
+          return l == r;
+        case OP_NE:
+          return l != r;
+        case OP_LT:
+          return l < r;
+        case OP_GT:
+          return l > r;
+        case OP_LE:
+          return l <= r;
+        case OP_GE:
+          return l >= r;
+        }
+      SPOT_UNREACHABLE();
+    }
+
     ////////////////////////////////////////////////////////////////////////
     // KRIPKE
 
@@ -729,38 +767,10 @@ namespace spot
       {
         bdd res = bddtrue;
         for (auto& i: *ps_)
-          {
-            int l = vars[i.var_num];
-            int r = i.val;
-
-            bool cond = false;
-            switch (i.op)
-              {
-              case OP_EQ:
-                cond = (l == r);
-                break;
-              case OP_NE:
-                cond = (l != r);
-                break;
-              case OP_LT:
-                cond = (l < r);
-                break;
-              case OP_GT:
-                cond = (l > r);
-                break;
-              case OP_LE:
-                cond = (l <= r);
-                break;
-              case OP_GE:
-                cond = (l >= r);
-                break;
-              }
-
-            if (cond)
-              res &= bdd_ithvar(i.bddvar);
-            else
-              res &= bdd_nithvar(i.bddvar);
-          }
+          if (eval_prop(i, vars))
+            res &= bdd_ithvar(i.bddvar);
+          else
+            res &= bdd_nithvar(i.bddvar);
         return res;
       }
 
@@ -938,6 +948,297 @@ namespace spot
     };
 
 
+    ////////////////////////////////////////////////////////////////////////
+    // PARALLEL EXPLORATION
+
+    // A state found by the parallel exploration.  It is allocated in
+    // the pool of the thread that found it first, and stores the
+    // (possibly compressed) variables of the state.
+    struct explored_state
+    {
+      // The number of the first state having this state as successor
+      // (in the order of a sequential BFS) in the upper 32 bits, and
+      // the rank of that successor in the lower bits.  This is
+      // protected by the lock of the shard containing the state.
+      std::uint64_t first_seen;
+      unsigned num;
+      unsigned hash;
+      int size;
+      int vars[1];
+    };
+
+    struct explored_state_hash
+    {
+      size_t operator()(const explored_state* s) const noexcept
+      {
+        return s->hash;
+      }
+    };
+
+    struct explored_state_equal
+    {
+      bool operator()(const explored_state* a,
+                      const explored_state* b) const noexcept
+      {
+        return a->size == b->size
+          && !memcmp(a->vars, b->vars, a->size * sizeof(*a->vars));
+      }
+    };
+
+    // The set of all states found so far.  It is split into shards
+    // that are locked independently.
+    class explored_table
+    {
+      struct shard
+      {
+        std::mutex lock;
+        std::unordered_set<explored_state*, explored_state_hash,
+                           explored_state_equal> states;
+      };
+      static constexpr unsigned nshards = 256;
+      shard shards_[nshards];
+
+    public:
+      // Insert s, or return the equal state already present.
+      explored_state* insert(explored_state* s)
+      {
+        shard& sh = shards_[(s->hash >> 8) % nshards];
+        std::lock_guard<std::mutex> guard(sh.lock);
+        auto p = sh.states.insert(s);
+        if (p.second)
+          return s;
+        explored_state* old = *p.first;
+        if (s->first_seen < old->first_seen)
+          old->first_seen = s->first_seen;
+        return old;
+      }
+    };
+
+    // The data of one thread of the exploration.
+    struct explore_worker
+    {
+      spins_interface_ptr d;
+      explored_table* table;
+      int state_size;
+      void (*compress)(const int*, size_t, int*, size_t&);
+      void (*decompress)(const int*, size_t, int*, size_t);
+      std::vector<int> uncompressed;
+      std::vector<int> compressed;
+      multiple_size_pool pool;
+
+      // States found for the first time by this thread during the
+      // current level.
+      std::vector<explored_state*> found;
+      // For each state expanded during the current level: its
+      // successors (concatenated), the value of each observed
+      // proposition followed by whether it is dead.
+      std::vector<explored_state*> succs;
+      std::vector<unsigned> succ_end;
+      std::vector<bool> labels;
+
+      std::uint64_t parent;
+      unsigned rank;
+
+      explore_worker(spins_interface_ptr iface, explored_table* tab,
+                     int compress_level)
+        : d(iface), table(tab), state_size(iface->get_state_size()),
+          compress(compress_level == 0 ? nullptr
+                   : compress_level == 1 ? int_array_array_compress
+                   : int_array_array_compress2),
+          decompress(compress_level == 0 ? nullptr
+                     : compress_level == 1 ? int_array_array_decompress
+                     : int_array_array_decompress2),
+          uncompressed(compress ? state_size + 30 : 0),
+          compressed(compress ? state_size * 2 : 0)
+      {
+      }
+
+      explored_state* make_state(const int* vars)
+      {
+        size_t size = state_size;
+        if (compress)
+          {
+            size = state_size * 2;
+            compress(vars, state_size, compressed.data(), size);
+            vars = compressed.data();
+          }
+        void* mem = pool.allocate(sizeof(explored_state)
+                                  - sizeof(explored_state::vars)
+                                  + size * sizeof(int));
+        explored_state* s = new(mem) explored_state;
+        s->num = -1U;
+        s->size = size;
+        memcpy(s->vars, vars, size * sizeof(int));
+        unsigned h = 0;
+        for (size_t i = 0; i < size; ++i)
+          h = wang32_hash(h ^ vars[i]);
+        s->hash = h;
+        return s;
+      }
+
+      void release(explored_state* s)
+      {
+        pool.deallocate(s, sizeof(explored_state)
+                        - sizeof(explored_state::vars)
+                        + s->size * sizeof(int));
+      }
+
+      static void callback(void* arg, transition_info_t*, int* dst)
+      {
+        explore_worker* w = static_cast<explore_worker*>(arg);
+        explored_state* s = w->make_state(dst);
+        s->first_seen = w->parent | w->rank++;
+        explored_state* t = w->table->insert(s);
+        if (t == s)
+          w->found.push_back(s);
+        else
+          w->release(s);
+        w->succs.push_back(t);
+      }
+
+      // Expand the states of [b,e).
+      void expand(explored_state* const* b, explored_state* const* e,
+                  const prop_set& ps)
+      {
+        found.clear();
+        succs.clear();
+        succ_end.clear();
+        labels.clear();
+        for (; b != e; ++b)
+          {
+            const int* vars = (*b)->vars;
+            if (decompress)
+              {
+                decompress(vars, (*b)->size, uncompressed.data(),
+                           state_size);
+                vars = uncompressed.data();
+              }
+            for (auto& p: ps)
+              labels.push_back(eval_prop(p, vars));
+            parent = std::uint64_t((*b)->num) << 32;
+            rank = 0;
+            int t = d->get_successors(nullptr, const_cast<int*>(vars),
+                                      callback, this);
+            labels.push_back(t == 0);
+            succ_end.push_back(succs.size());
+          }
+      }
+    };
+
+    kripke_graph_ptr
+    explore_model(spins_interface_ptr d, const atomic_prop_set* to_observe,
+                  bdd_dict_ptr dict, formula dead, int compress,
+                  parallel_policy ppolicy)
+    {
+      auto res = make_kripke_graph(dict);
+      // Register the propositions to the automaton first, since
+      // twa::register_ap() ignores those already registered for it.
+      for (auto ap: *to_observe)
+        res->register_ap(ap);
+      prop_set ps;
+      convert_aps(to_observe, d, dict, dead, ps, res.get());
+
+      // See the constructor of spins_kripke.
+      bdd alive_prop = bddtrue;
+      bdd dead_prop = bddtrue;
+      if (dead.is_ff())
+        {
+          dead_prop = bddfalse;
+        }
+      else if (!dead.is_tt())
+        {
+          int var = res->register_ap(dead);
+          dead_prop = bdd_ithvar(var);
+          alive_prop = bdd_nithvar(var);
+        }
+
+      unsigned nthreads = ppolicy.nthreads();
+      std::unique_ptr<explored_table> table(new explored_table);
+      std::vector<std::unique_ptr<explore_worker>> workers;
+      for (unsigned i = 0; i < nthreads; ++i)
+        workers.emplace_back(new explore_worker(d, table.get(), compress));
+
+      std::vector<int> init(d->get_state_size() + 1);
+      d->get_initial_state(init.data());
+      explored_state* s0 = workers[0]->make_state(init.data());
+      s0->first_seen = 0;
+      s0->num = 0;
+      table->insert(s0);
+      res->new_state(bddfalse);
+
+      // The labels are converted to BDDs by the calling thread.
+      std::unordered_map<std::vector<bool>, bdd> conds;
+      unsigned nlabels = ps.size() + 1;
+      std::vector<bool> label(nlabels);
+
+      std::vector<explored_state*> frontier = { s0 };
+      std::vector<explored_state*> next;
+      unsigned nstates = 1;
+      while (!frontier.empty())
+        {
+          size_t n = frontier.size();
+          unsigned nt = internal::parallel_threads(ppolicy, n, 64);
+          internal::parallel_ranges(nt, n,
+                                    [&](unsigned i, size_t b, size_t e)
+                                    {
+                                      workers[i]->expand(frontier.data() + b,
+                                                         frontier.data() + e,
+                                                         ps);
+                                    });
+
+          // Number the new states as a sequential BFS would.
+          next.clear();
+          for (unsigned i = 0; i < nt; ++i)
+            next.insert(next.end(),
+                        workers[i]->found.begin(), workers[i]->found.end());
+          internal::parallel_sort(next.begin(), next.end(),
+                                  [](const explored_state* a,
+                                     const explored_state* b)
+                                  {
+                                    return a->first_seen < b->first_seen;
+                                  }, nt);
+          for (auto* s: next)
+            s->num = nstates++;
+          if (!next.empty())
+            res->new_states(next.size(), bddfalse);
+
+          // Label the states of the level, and add their edges.
+          auto src = frontier.begin();
+          for (unsigned i = 0; i < nt; ++i)
+            {
+              explore_worker& w = *workers[i];
+              unsigned sb = 0;
+              unsigned nexp = w.succ_end.size();
+              for (unsigned k = 0; k < nexp; ++k, ++src)
+                {
+                  std::copy(w.labels.begin() + k * nlabels,
+                            w.labels.begin() + (k + 1) * nlabels,
+                            label.begin());
+                  auto p = conds.emplace(label, bddfalse);
+                  if (p.second)
+                    {
+                      bdd c = label.back() ? dead_prop : alive_prop;
+                      for (unsigned j = 0; j < ps.size(); ++j)
+                        c &= label[j] ? bdd_ithvar(ps[j].bddvar)
+                          : bdd_nithvar(ps[j].bddvar);
+                      p.first->second = c;
+                    }
+                  bdd cond = p.first->second;
+                  unsigned s = (*src)->num;
+                  res->state_from_number(s)->cond(cond);
+                  for (; sb < w.succ_end[k]; ++sb)
+                    res->new_edge(s, w.succs[sb]->num);
+                  // Add a self-loop to dead-states if we care about these.
+                  if (label.back() && cond != bddfalse)
+                    res->new_edge(s, s);
+                }
+            }
+          frontier.swap(next);
+        }
+      return res;
+    }
+
+
     //////////////////////////////////////////////////////////////////////////
     // LOADER
 
@@ -1091,7 +1392,7 @@ namespace spot
     spot::prop_set* ps = new spot::prop_set;
     try
       {
-        convert_aps(to_observe, iface, dict, dead, *ps);
+        convert_aps(to_observe, iface, dict, dead, *ps, iface.get());
       }
     catch (const std::runtime_error&)
       {
@@ -1110,6 +1411,14 @@ namespace spot
     return res;
   }
 
+  kripke_graph_ptr
+  ltsmin_model::explicit_kripke(const atomic_prop_set* to_observe,
+                                bdd_dict_ptr dict, const formula dead,
+                                int compress, parallel_policy ppolicy) const
+  {
+    return explore_model(iface, to_observe, dict, dead, compress, ppolicy);
+  }
+
   ltsmin_model::~ltsmin_model()
   {
   }
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2013, 2014, 2015, 2016 Laboratoire de Recherche et
+// Copyright (C) 2011, 2013-2016, 2018 Laboratoire de Recherche et
 // Developpement de l'Epita (LRDE)
 //
 // This file is part of Spot, a model checking library.
@@ -19,7 +19,7 @@
 
 #pragma once
 
-#include <spot/kripke/kripke.hh>
+#include <spot/kripke/kripkegraph.hh>
 #include <spot/tl/apcollect.hh>
 
 namespace spot
@@ -71,6 +71,35 @@ namespace spot
                       formula dead = formula::tt(),
                       int compress = 0) const;
 
+    // \brief Generate the reachable state space as a kripke_graph
+    //
+    // The arguments are the same as for kripke(), and the result has
+    // the same states (named only by their numbers), labels, and
+    // transitions, but the state space is explored beforehand, in
+    // breadth-first order, using up to ppolicy.nthreads() threads.
+    // Each thread expands part of the current level of the search,
+    // with its own (de)compression buffers, and inserts the
+    // successors into a table shared by all threads.  States are
+    // numbered in the order of a sequential breadth-first search
+    // whatever the number of threads.  Here \a compress only reduces
+    // the memory used during the exploration.
+    //
+    // The successor function of the model is called by several
+    // threads at once, so it must be reentrant.
+    //
+    // The result can be combined with a property using otf_product(),
+    // and the reachable part of that product can be copied into a
+    // twa_graph to be given to a multi-threaded emptiness check such
+    // as ufscc() or cndfs().
+#ifndef SWIG
+    kripke_graph_ptr explicit_kripke(const atomic_prop_set* to_observe,
+                                     bdd_dict_ptr dict,
+                                     formula dead = formula::tt(),
+                                     int compress = 0,
+                                     parallel_policy ppolicy
+                                     = parallel_policy()) const;
+#endif
+
     /// Number of variables in a state
     int state_size() const;
     /// Name of each variable
@@ -1,6 +1,6 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013, 2014, 2015, 2016, 2017 Laboratoire de Recherche et
-// Développement de l'Epita (LRDE).
+// Copyright (C) 2013, 2014, 2015, 2016, 2017, 2018 Laboratoire de
+// Recherche et Développement de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
 //
@@ -20,6 +20,8 @@
 #include <cstdlib>
 #include <stdexcept>
 #include <cassert>
+#include <functional>
+#include <spot/misc/_config.h>
 
 #pragma once
 
@@ -162,4 +164,111 @@ namespace spot
       {
       }
   };
+
+  /// \brief Resources a parallel algorithm may use.
+  ///
+  /// This holds the maximum number of threads the algorithm is
+  /// allowed to start, and the minimum number of items (states,
+  /// edges...) each of these threads should receive.  When Spot has
+  /// been configured without --enable-pthread, nthreads() is always
+  /// 1 and every algorithm runs sequentially.
+  ///
+  /// The BDD library is not thread-safe: code running in worker
+  /// threads must neither call BDD operations, nor create, copy, or
+  /// destroy bdd objects, because reference counts are updated
+  /// without synchronization.  Reading the id() of a bdd owned by
+  /// the calling thread is fine.
+  class SPOT_API parallel_policy
+  {
+#ifdef SPOT_ENABLE_PTHREAD
+    unsigned nthreads_;
+    unsigned grain_;
+#endif
+
+  public:
+    /// \brief Create a policy.
+    ///
+    /// By default, algorithms run sequentially.  If \a nthreads is
+    /// 0, default_nthreads() is used.  If \a grain is 0, each
+    /// algorithm uses its own default, chosen so that small inputs
+    /// are processed sequentially.  A small non-zero grain forces
+    /// the parallel code to be used even on tiny inputs, which is
+    /// mostly useful for testing.
+    parallel_policy(unsigned nthreads = 1, unsigned grain = 0)
+#ifdef SPOT_ENABLE_PTHREAD
+      : nthreads_(nthreads ? nthreads : default_nthreads()),
+        grain_(grain)
+#endif
+    {
+#ifndef SPOT_ENABLE_PTHREAD
+      (void) nthreads;
+      (void) grain;
+#endif
+    }
+
+    /// The maximum number of threads to use.
+    unsigned nthreads() const
+    {
+#ifdef SPOT_ENABLE_PTHREAD
+      return nthreads_;
+#else
+      return 1;
+#endif
+    }
+
+    /// \brief The minimum number of items per thread.
+    ///
+    /// 0 means that each algorithm uses its own default.
+    unsigned grain() const
+    {
+#ifdef SPOT_ENABLE_PTHREAD
+      return grain_;
+#else
+      return 0;
+#endif
+    }
+
+    /// \brief The default number of threads.
+    ///
+    /// This is the value of the SPOT_THREADS environment variable if
+    /// it is set, or the number of hardware threads otherwise.  It is
+    /// always 1 when Spot has been configured without
+    /// --enable-pthread.
+    static unsigned default_nthreads();
+  };
+
+#ifndef SWIG
+  namespace internal
+  {
+    // The default number of items a thread should receive.  On
+    // smaller inputs, starting threads costs more than it saves.
+    constexpr size_t parallel_grain = 1 << 16;
+
+    // The number of threads to use to process n items, if each
+    // thread should receive at least grain items.  The grain of
+    // ppolicy, if any, overrides the grain given by the algorithm.
+    inline unsigned
+    parallel_threads(const parallel_policy& ppolicy, size_t n,
+                     size_t grain = parallel_grain)
+    {
+      unsigned t = ppolicy.nthreads();
+      if (t <= 1)
+        return 1;
+      if (ppolicy.grain())
+        grain = ppolicy.grain();
+      size_t m = n / (grain ? grain : 1);
+      if (m < t)
+        t = m ? m : 1;
+      return t;
+    }
+
+    // Split [0,n) into nthreads consecutive ranges, and call
+    // f(i, begin, end) on the i-th range in its own thread.  The
+    // first range is processed by the calling thread.  An exception
+    // raised by f() is rethrown once all threads have finished.
+    SPOT_API void
+    parallel_ranges(unsigned nthreads, size_t n,
+                    const std::function<void(unsigned, size_t, size_t)>& f);
+  }
+#endif
 }
@@ -0,0 +1,120 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <spot/misc/memres.hh>
+#include <cstdint>
+#include <new>
+
+namespace spot
+{
+  memory_resource::~memory_resource()
+  {
+  }
+
+  namespace
+  {
+    class new_delete_resource_t final: public memory_resource
+    {
+    protected:
+      void* do_allocate(size_t bytes, size_t alignment) override
+      {
+        SPOT_ASSERT(alignment <= alignof(std::max_align_t));
+        (void) alignment;
+        return ::operator new(bytes);
+      }
+
+      void do_deallocate(void* p, size_t, size_t) override
+      {
+        ::operator delete(p);
+      }
+    };
+
+    static new_delete_resource_t new_delete;
+    static thread_local memory_resource* default_resource = &new_delete;
+  }
+
+  memory_resource* new_delete_resource() noexcept
+  {
+    return &new_delete;
+  }
+
+  memory_resource* get_default_resource() noexcept
+  {
+    return default_resource;
+  }
+
+  memory_resource* set_default_resource(memory_resource* r) noexcept
+  {
+    memory_resource* old = default_resource;
+    default_resource = r ? r : &new_delete;
+    return old;
+  }
+
+  monotonic_buffer_resource::
+  monotonic_buffer_resource(size_t initial_size, memory_resource* upstream)
+    : next_size_(initial_size ? initial_size : 1),
+      initial_size_(next_size_), upstream_(upstream)
+  {
+  }
+
+  monotonic_buffer_resource::~monotonic_buffer_resource()
+  {
+    release();
+  }
+
+  void monotonic_buffer_resource::release()
+  {
+    while (chunks_)
+      {
+        chunk* prev = chunks_->prev;
+        upstream_->deallocate(chunks_, chunks_->size);
+        chunks_ = prev;
+      }
+    cur_ = end_ = nullptr;
+    next_size_ = initial_size_;
+  }
+
+  void*
+  monotonic_buffer_resource::do_allocate(size_t bytes, size_t alignment)
+  {
+    SPOT_ASSERT(alignment <= alignof(std::max_align_t));
+    uintptr_t p = reinterpret_cast<uintptr_t>(cur_);
+    p = (p + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (SPOT_UNLIKELY(!cur_ || p + bytes > reinterpret_cast<uintptr_t>(end_)))
+      {
+        // The chunk header is followed by suitably aligned memory.
+        const size_t header = ((sizeof(chunk) + alignof(std::max_align_t) - 1)
+                               & ~(alignof(std::max_align_t) - 1));
+        while (next_size_ < bytes + header)
+          next_size_ *= 2;
+        size_t size = next_size_;
+        chunk* c = static_cast<chunk*>(upstream_->allocate(size));
+        c->prev = chunks_;
+        c->size = size;
+        chunks_ = c;
+        next_size_ *= 2;
+        cur_ = reinterpret_cast<char*>(c) + header;
+        end_ = reinterpret_cast<char*>(c) + size;
+        p = reinterpret_cast<uintptr_t>(cur_);
+      }
+    cur_ = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+  }
+}
@@ -0,0 +1,251 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/misc/common.hh>
+#include <cstddef>
+
+namespace spot
+{
+  /// \ingroup misc_tools
+  /// \brief An abstract source of memory.
+  ///
+  /// This has the same interface as C++17's
+  /// std::pmr::memory_resource, which Spot cannot use as long as it
+  /// supports C++14.  The storage of spot::digraph (and therefore
+  /// of spot::twa_graph) is allocated from such a resource.
+  class SPOT_API memory_resource
+  {
+  public:
+    virtual ~memory_resource();
+
+    void* allocate(size_t bytes,
+                   size_t alignment = alignof(std::max_align_t))
+    {
+      return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void* p, size_t bytes,
+                    size_t alignment = alignof(std::max_align_t))
+    {
+      do_deallocate(p, bytes, alignment);
+    }
+
+    bool is_equal(const memory_resource& other) const noexcept
+    {
+      return do_is_equal(other);
+    }
+
+  protected:
+    virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource& other) const noexcept
+    {
+      return this == &other;
+    }
+  };
+
+  inline bool operator==(const memory_resource& a,
+                         const memory_resource& b) noexcept
+  {
+    return &a == &b || a.is_equal(b);
+  }
+
+  inline bool operator!=(const memory_resource& a,
+                         const memory_resource& b) noexcept
+  {
+    return !(a == b);
+  }
+
+  /// \ingroup misc_tools
+  /// \brief The resource that uses operator new and operator delete.
+  SPOT_API memory_resource* new_delete_resource() noexcept;
+
+  /// \ingroup misc_tools
+  /// \brief The resource used by containers that are not given an
+  /// explicit one.
+  ///
+  /// Unlike std::pmr::get_default_resource(), this setting is
+  /// per-thread.  It is new_delete_resource() unless changed by
+  /// set_default_resource().
+  SPOT_API memory_resource* get_default_resource() noexcept;
+
+  /// \ingroup misc_tools
+  /// \brief Change the default resource of the current thread.
+  ///
+  /// \param r the new default resource, or nullptr to restore
+  /// new_delete_resource().
+  /// \return the previous default resource.
+  SPOT_API memory_resource* set_default_resource(memory_resource* r) noexcept;
+
+  /// \ingroup misc_tools
+  /// \brief Install a default resource for the current scope.
+  ///
+  /// The previous default resource is restored on destruction.
+  class SPOT_API default_resource_scope final
+  {
+  public:
+    explicit default_resource_scope(memory_resource* r) noexcept
+      : old_(set_default_resource(r))
+    {
+    }
+
+    ~default_resource_scope()
+    {
+      set_default_resource(old_);
+    }
+
+    default_resource_scope(const default_resource_scope&) = delete;
+    default_resource_scope&
+    operator=(const default_resource_scope&) = delete;
+
+    /// The default resource that was active before this scope.
+    memory_resource* previous() const noexcept
+    {
+      return old_;
+    }
+
+  private:
+    memory_resource* old_;
+  };
+
+  /// \ingroup misc_tools
+  /// \brief A resource that never reuses memory.
+  ///
+  /// Memory is carved out of chunks of increasing size obtained from
+  /// an upstream resource.  Deallocation does nothing: all memory is
+  /// given back at once by release(), or when the resource is
+  /// destroyed.  Any object using this resource must therefore be
+  /// destroyed before.  This is meant for computations that create
+  /// and throw away many short-lived objects.
+  class SPOT_API monotonic_buffer_resource final: public memory_resource
+  {
+  public:
+    /// \brief Create an empty resource.
+    ///
+    /// \param initial_size the size of the first chunk to request
+    /// from \a upstream; later chunks double in size.
+    /// \param upstream where chunks are allocated.
+    explicit monotonic_buffer_resource(size_t initial_size = 4096,
+                                       memory_resource* upstream =
+                                       new_delete_resource());
+    ~monotonic_buffer_resource();
+
+    monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+    monotonic_buffer_resource&
+    operator=(const monotonic_buffer_resource&) = delete;
+
+    /// Give all chunks back to the upstream resource.
+    void release();
+
+    memory_resource* upstream_resource() const noexcept
+    {
+      return upstream_;
+    }
+
+  protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override
+    {
+    }
+
+  private:
+    struct chunk
+    {
+      chunk* prev;
+      size_t size;
+    };
+    chunk* chunks_ = nullptr;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    size_t next_size_;
+    size_t initial_size_;
+    memory_resource* upstream_;
+  };
+
+  /// \ingroup misc_tools
+  /// \brief An allocator that draws memory from a memory_resource.
+  ///
+  /// This behaves as C++17's std::pmr::polymorphic_allocator.  A
+  /// default-constructed allocator uses get_default_resource(), and
+  /// copies of containers use the default resource active at the
+  /// time of the copy.  The resource of a container never changes
+  /// on assignment or swap, so containers using different resources
+  /// should not be swapped.
+  template <typename T>
+  class polymorphic_allocator
+  {
+  public:
+    typedef T value_type;
+
+    polymorphic_allocator() noexcept
+      : res_(get_default_resource())
+    {
+    }
+
+    polymorphic_allocator(memory_resource* r) noexcept
+      : res_(r)
+    {
+    }
+
+    template <typename U>
+    polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
+      : res_(other.resource())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+      return static_cast<T*>(res_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+      res_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    polymorphic_allocator select_on_container_copy_construction() const
+    {
+      return {};
+    }
+
+    memory_resource* resource() const noexcept
+    {
+      return res_;
+    }
+
+  private:
+    memory_resource* res_;
+  };
+
+  template <typename T, typename U>
+  bool operator==(const polymorphic_allocator<T>& a,
+                  const polymorphic_allocator<U>& b) noexcept
+  {
+    return *a.resource() == *b.resource();
+  }
+
+  template <typename T, typename U>
+  bool operator!=(const polymorphic_allocator<T>& a,
+                  const polymorphic_allocator<U>& b) noexcept
+  {
+    return !(a == b);
+  }
+}
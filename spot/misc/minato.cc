@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2009, 2013, 2014, 2015 Laboratoire de Recherche et
+// Copyright (C) 2009, 2013, 2014, 2015, 2018 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004 Laboratoire d'Informatique de Paris
 // 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
@@ -92,11 +92,15 @@ namespace spot
               // constants (bddtrue or bddfalse) because one of the
               // two above `if' would have matched; so it's ok to call
               // bdd_var().
+              // Compare levels rather than variable numbers, as they
+              // differ once BuDDy has reordered variables.  Since
+              // bdd_restrict() may trigger a reordering, each level
+              // is read just before it is used.
               int v = bdd_var(l.vars);
               l.vars = bdd_high(l.vars);
-              int v_min = bdd_var(l.f_min);
-              int v_max = bdd_var(l.f_max);
-              if (v < v_min && v < v_max)
+              int lv = bdd_var2level(v);
+              if (lv < bdd_var2level(bdd_var(l.f_min))
+                  && lv < bdd_var2level(bdd_var(l.f_max)))
                 // Do not use a while() for this goto, because we want
                 // `continue' to be relative to the outermost while().
                 goto next_var;
@@ -112,12 +116,13 @@ namespace spot
               //   f1_min = bdd_restrict(f_min, v1);
               //   f1_max = bdd_restrict(f_max, v1);
               // but we try to avoid bdd_restrict when possible.
-              if (v == v_min)
+              int lv_min = bdd_var2level(bdd_var(l.f_min));
+              if (lv == lv_min)
                 {
                   l.f0_min = bdd_low(l.f_min);
                   l.f1_min = bdd_high(l.f_min);
                 }
-              else if (v_min < v)
+              else if (lv_min < lv)
                 {
                   l.f0_min = bdd_restrict(l.f_min, v0);
                   l.f1_min = bdd_restrict(l.f_min, l.v1);
@@ -126,12 +131,14 @@ namespace spot
                 {
                   l.f1_min = l.f0_min = l.f_min;
                 }
-              if (v == v_max)
+              lv = bdd_var2level(v);
+              int lv_max = bdd_var2level(bdd_var(l.f_max));
+              if (lv == lv_max)
                 {
                   l.f0_max = bdd_low(l.f_max);
                   l.f1_max = bdd_high(l.f_max);
                 }
-              else if (v_max < v)
+              else if (lv_max < lv)
                 {
                   l.f0_max = bdd_restrict(l.f_max, v0);
                   l.f1_max = bdd_restrict(l.f_max, l.v1);
@@ -0,0 +1,108 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <spot/misc/common.hh>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#ifdef SPOT_ENABLE_PTHREAD
+#  include <exception>
+#  include <thread>
+#endif
+
+namespace spot
+{
+  unsigned parallel_policy::default_nthreads()
+  {
+#ifdef SPOT_ENABLE_PTHREAD
+    static unsigned n = []()
+      {
+        const char* c = getenv("SPOT_THREADS");
+        if (!c)
+          {
+            unsigned hw = std::thread::hardware_concurrency();
+            return hw ? hw : 1U;
+          }
+        errno = 0;
+        char* end;
+        long val = strtol(c, &end, 10);
+        if (val <= 0 || val > INT_MAX || errno != 0 || *end != 0)
+          throw std::runtime_error("unexpected value for SPOT_THREADS");
+        return unsigned(val);
+      }();
+    return n;
+#else
+    return 1;
+#endif
+  }
+
+  namespace internal
+  {
+    void
+    parallel_ranges(unsigned nthreads, size_t n,
+                    const std::function<void(unsigned, size_t, size_t)>& f)
+    {
+#ifdef SPOT_ENABLE_PTHREAD
+      if (nthreads > 1)
+        {
+          std::vector<std::exception_ptr> errors(nthreads);
+          auto run = [&](unsigned i)
+            {
+              try
+                {
+                  f(i, n * i / nthreads, n * (i + 1) / nthreads);
+                }
+              catch (...)
+                {
+                  errors[i] = std::current_exception();
+                }
+            };
+          std::vector<std::thread> workers;
+          workers.reserve(nthreads - 1);
+          try
+            {
+              for (unsigned i = 1; i < nthreads; ++i)
+                workers.emplace_back(run, i);
+            }
+          catch (...)
+            {
+              // Destroying a joinable std::thread would call
+              // std::terminate().
+              for (auto& w: workers)
+                w.join();
+              throw;
+            }
+          run(0);
+          for (auto& w: workers)
+            w.join();
+          for (auto& e: errors)
+            if (e)
+              std::rethrow_exception(e);
+          return;
+        }
+#else
+      (void) nthreads;
+#endif
+      f(0U, size_t(0), n);
+    }
+  }
+}
@@ -0,0 +1,50 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE)
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <spot/misc/strpool.hh>
+
+namespace spot
+{
+  string_pool
+  string_pool::renumbered(const std::vector<unsigned>& newidx,
+                          unsigned newsize) const
+  {
+    // from[d] is the index of the string that should become
+    // string d.
+    std::vector<unsigned> from(newsize, -1U);
+    unsigned n = size();
+    if (newidx.size() < n)
+      n = newidx.size();
+    for (unsigned i = 0; i < n; ++i)
+      {
+        unsigned d = newidx[i];
+        if (d < newsize)
+          from[d] = i;
+      }
+    string_pool res;
+    res.reserve(newsize, chars_.size());
+    for (unsigned f: from)
+      if (f == -1U)
+        res.push_back("", 0);
+      else
+        res.push_back(c_str(f), length(f));
+    return res;
+  }
+}
@@ -0,0 +1,141 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE)
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/misc/common.hh>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace spot
+{
+  /// \ingroup misc_tools
+  /// \brief A compact sequence of strings.
+  ///
+  /// All strings are stored one after the other, each followed by a
+  /// NUL character, in a single buffer, and are designated by their
+  /// index in the sequence.  Compared to a
+  /// <code>std::vector<std::string></code>, this saves the size of a
+  /// std::string object (usually 32 bytes) and one allocation per
+  /// long string, for a cost of one offset per string.
+  ///
+  /// This is the type of the "state-name-pool" named property,
+  /// where string \c i is the name of state \c i.
+  class SPOT_API string_pool final
+  {
+  public:
+    string_pool()
+    {
+      offsets_.push_back(0);
+    }
+
+    /// The number of strings in the pool.
+    unsigned size() const
+    {
+      return offsets_.size() - 1;
+    }
+
+    /// Whether the pool contains no string.
+    bool empty() const
+    {
+      return offsets_.size() == 1;
+    }
+
+    /// \brief Reserve memory for \a n strings totaling \a chars
+    /// characters.
+    void reserve(unsigned n, std::size_t chars = 0)
+    {
+      offsets_.reserve(n + 1);
+      chars_.reserve(chars + n);
+    }
+
+    /// \brief Append a string of \a len characters at the end of the
+    /// pool and return its index.
+    unsigned push_back(const char* s, std::size_t len)
+    {
+      chars_.insert(chars_.end(), s, s + len);
+      chars_.push_back(0);
+      offsets_.push_back(chars_.size());
+      return size() - 1;
+    }
+
+    /// \brief Append a string at the end of the pool and return its
+    /// index.
+    unsigned push_back(const std::string& s)
+    {
+      return push_back(s.data(), s.size());
+    }
+
+    /// \brief Append a NUL-terminated string at the end of the pool
+    /// and return its index.
+    unsigned push_back(const char* s)
+    {
+      return push_back(s, strlen(s));
+    }
+
+    /// \brief The string at index \a i, as a NUL-terminated string.
+    ///
+    /// The returned pointer is invalidated by push_back().
+    const char* c_str(unsigned i) const
+    {
+      return chars_.data() + offsets_[i];
+    }
+
+    /// The length of the string at index \a i.
+    std::size_t length(unsigned i) const
+    {
+      return offsets_[i + 1] - offsets_[i] - 1;
+    }
+
+    /// A copy of the string at index \a i.
+    std::string str(unsigned i) const
+    {
+      return std::string(c_str(i), length(i));
+    }
+
+    /// A copy of the string at index \a i.
+    std::string operator[](unsigned i) const
+    {
+      return str(i);
+    }
+
+    /// \brief Return a renumbered copy of the pool.
+    ///
+    /// String \c i of this pool becomes string \c newidx[i] of the
+    /// result, unless \c newidx[i] is not less than \a newsize (for
+    /// instance \c -1U), in which case string \c i is dropped.  The
+    /// result has \a newsize strings; those that have no antecedent
+    /// are empty.
+    string_pool renumbered(const std::vector<unsigned>& newidx,
+                           unsigned newsize) const;
+
+    /// Release the memory reserved but unused.
+    void shrink_to_fit()
+    {
+      chars_.shrink_to_fit();
+      offsets_.shrink_to_fit();
+    }
+
+  private:
+    std::vector<char> chars_;
+    std::vector<std::size_t> offsets_;
+  };
+}
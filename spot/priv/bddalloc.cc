@@ -1,6 +1,6 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2007, 2011, 2014, 2015, 2017 Laboratoire de Recherche et
-// Développement de l'Epita (LRDE).
+// Copyright (C) 2007, 2011, 2014, 2015, 2017, 2018 Laboratoire de
+// Recherche et Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004, 2006, 2007 Laboratoire d'Informatique de
 // Paris 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
 // Université Pierre et Marie Curie.
@@ -24,12 +24,163 @@
 #include <cassert>
 #include <cstdlib>
 #include <ctime>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <spot/misc/common.hh>
 #include "spot/priv/bddalloc.hh"
 
 namespace spot
 {
 
+#ifdef SPOT_ENABLE_PTHREAD
+  thread_local bool bdd_allocator::initialized = false;
+
+  namespace
+  {
+    // BuDDy is compiled with a thread-local state, so every thread
+    // that uses BDDs has its own node table and caches.  Release them
+    // when a thread terminates.  The manager of the main thread is
+    // kept until the end, as before, because static objects may still
+    // hold BDDs when thread-local objects are destroyed.
+    const std::thread::id main_thread = std::this_thread::get_id();
+
+    struct bdd_thread_cleanup
+    {
+      ~bdd_thread_cleanup()
+      {
+        if (std::this_thread::get_id() != main_thread && bdd_isrunning())
+          bdd_done();
+      }
+    };
+  }
+#else
   bool bdd_allocator::initialized = false;
+#endif
+
+  namespace
+  {
+    // Dynamic reordering is only enabled on request, because it is
+    // not always a win, and it makes the order of variables (hence
+    // the order in which minterms are printed) depend on the history
+    // of BDD operations.
+    struct reorder_state
+    {
+      bool enabled = false;
+      // Ranges of variables allocated together, as first->last.
+      // They do not overlap.
+      std::map<int, int> ranges;
+    };
+
+    reorder_state& reordering()
+    {
+#ifdef SPOT_ENABLE_PTHREAD
+      static thread_local reorder_state rs;
+#else
+      static reorder_state rs;
+#endif
+      return rs;
+    }
+
+    int reorder_method(const char* m)
+    {
+      static const struct { const char* name; int method; } methods[] =
+        {
+          { "sift", BDD_REORDER_SIFT },
+          { "siftite", BDD_REORDER_SIFTITE },
+          { "win2", BDD_REORDER_WIN2 },
+          { "win2ite", BDD_REORDER_WIN2ITE },
+          { "win3", BDD_REORDER_WIN3 },
+          { "win3ite", BDD_REORDER_WIN3ITE },
+          { "random", BDD_REORDER_RANDOM },
+        };
+      for (auto& p: methods)
+        if (!strcmp(m, p.name))
+          return p.method;
+      throw std::runtime_error(std::string("SPOT_BDD_REORDER: unknown "
+                                           "reordering method '") + m
+                               + "'; expected sift, siftite, win2, "
+                               "win2ite, win3, win3ite, or random");
+    }
+
+    // Variables that are not in any block are never moved by BuDDy,
+    // so every variable gets a block.  Variables allocated together
+    // (e.g., the acceptance variables of an automaton, or the class
+    // variables used by simulation) form a fixed block, so that they
+    // are moved as a group, and keep their relative order.  A range
+    // whose variables are not adjacent in the current order (this
+    // happens when a range is formed from variables freed by
+    // different allocations) is split into single variables.
+    void rebuild_blocks()
+    {
+      bdd_clrvarblocks();
+      int varnum = bdd_varnum();
+      int v = 0;
+      for (auto& r: reordering().ranges)
+        {
+          for (; v < r.first; ++v)
+            bdd_intaddvarblock(v, v, BDD_REORDER_FIXED);
+          int minl = bdd_var2level(r.first);
+          int maxl = minl;
+          for (int i = r.first + 1; i <= r.second; ++i)
+            {
+              int l = bdd_var2level(i);
+              minl = std::min(minl, l);
+              maxl = std::max(maxl, l);
+            }
+          if (maxl - minl == r.second - r.first)
+            bdd_intaddvarblock(r.first, r.second, BDD_REORDER_FIXED);
+          else
+            for (int i = r.first; i <= r.second; ++i)
+              bdd_intaddvarblock(i, i, BDD_REORDER_FIXED);
+          v = r.second + 1;
+        }
+      for (; v < varnum; ++v)
+        bdd_intaddvarblock(v, v, BDD_REORDER_FIXED);
+    }
+
+    // Remove [first,last] from the allocated ranges, splitting the
+    // ranges that overlap it.
+    void forget_range(int first, int last)
+    {
+      auto& ranges = reordering().ranges;
+      auto it = ranges.upper_bound(last);
+      while (it != ranges.begin())
+        {
+          --it;
+          if (it->second < first)
+            break;
+          int f = it->first;
+          int l = it->second;
+          it = ranges.erase(it);
+          if (l > last)
+            ranges.emplace(last + 1, l);
+          if (f < first)
+            ranges.emplace(f, first - 1);
+          it = ranges.lower_bound(f);
+        }
+    }
+
+    void add_range(int first, int last)
+    {
+      // Two bdd_dict may hand out the same variables; merge their
+      // ranges so that blocks never partially overlap.
+      auto& ranges = reordering().ranges;
+      auto it = ranges.upper_bound(last);
+      while (it != ranges.begin())
+        {
+          --it;
+          if (it->second < first)
+            break;
+          first = std::min(first, it->first);
+          last = std::max(last, it->second);
+          it = ranges.erase(it);
+        }
+      ranges.emplace(first, last);
+    }
+  }
 
   static void show_bdd_stats()
   {
@@ -45,6 +196,30 @@ namespace spot
               << " hashsize=" << s.hashsize
               << " gbcnum=" << s.gbcnum
               << '\n';
+    bddOpCacheStat os[BDD_OPCACHENUM];
+    int n = bdd_opcachestats(os, BDD_OPCACHENUM);
+    for (int i = 0; i < n; ++i)
+      {
+        unsigned long lookups = os[i].hits + os[i].misses;
+        if (!lookups)
+          continue;
+        std::cerr << "spot: BDD cache " << os[i].name
+                  << ": size=" << os[i].size
+                  << " hits=" << os[i].hits
+                  << " misses=" << os[i].misses
+                  << " (" << (os[i].hits * 100 / lookups)
+                  << "% hits) resizes=" << os[i].resizes
+                  << '\n';
+      }
+  }
+
+  static void show_final_bdd_stats()
+  {
+    // Python users may have called bdd_done() already.
+    if (!bdd_isrunning())
+      return;
+    std::cerr << "spot: final BDD stats\n";
+    show_bdd_stats();
   }
 
   static void resize_handler(int oldsize, int newsize)
@@ -53,18 +228,34 @@ namespace spot
               << oldsize << " -> " << newsize << '\n';
   }
 
+  static void reorder_handler(int prestate)
+  {
+    if (prestate)
+      std::cerr << "spot: BDD reordering started with "
+                << bdd_getnodenum() << " nodes\n";
+    else
+      std::cerr << "spot: BDD reordering done, " << bdd_getnodenum()
+                << " nodes (" << bdd_reorder_gain() << "% gain)\n";
+  }
+
   static void gbc_handler(int pre, bddGbcStat *s)
   {
     if (!pre)
       std::cerr << "spot: BDD GC #" << s->num
+                << (s->minor ? " (minor)" : "")
                 << " in " << ((float)s->time)/CLOCKS_PER_SEC << "s / "
-                << ((float)s->sumtime)/CLOCKS_PER_SEC << "s total\n";
+                << ((float)s->sumtime)/CLOCKS_PER_SEC << "s total, freed "
+                << s->freednodes << " nodes ("
+                << s->freedbytes << " bytes)\n";
     show_bdd_stats();
   }
 
   bdd_allocator::bdd_allocator()
   {
     initialize();
+#ifdef SPOT_ENABLE_PTHREAD
+    owner_ = std::this_thread::get_id();
+#endif
     lvarnum = bdd_varnum();
     fl.emplace_front(0, lvarnum);
   }
@@ -83,10 +274,33 @@ namespace spot
     // to tune this.  By the meantime, we take the typical values
     // for large examples advocated by the BuDDy manual.
     bdd_init(1 << 19, 2);
+#ifdef SPOT_ENABLE_PTHREAD
+    static thread_local bdd_thread_cleanup cleanup;
+    (void) cleanup;
+#endif
     bdd_setcacheratio(40);
     bdd_setvarnum(2);
     // When the node table is full, add 2**19 nodes; this requires 10MB.
     bdd_setmaxincrease(1 << 19);
+    // The operators do not all have the same reuse patterns, so let
+    // each cache grow up to 8 times the size implied by the above
+    // ratio if its hit rate suggests it is worth it.
+    {
+      int growth = 8;
+      if (const char* g = getenv("SPOT_BDD_CACHE_GROWTH"))
+        growth = std::max(1, atoi(g));
+      bdd_setmaxcachegrowth(growth);
+    }
+    // Dynamic reordering, if requested, is triggered by BuDDy once
+    // the number of used nodes reaches the initial size of the node
+    // table, and then each time it has at least doubled since the
+    // last reordering.
+    if (const char* m = getenv("SPOT_BDD_REORDER"))
+      {
+        bdd_autoreorder(reorder_method(m));
+        reordering().enabled = true;
+        rebuild_blocks();
+      }
     // Disable the default GC handler.  (Note that this will only be
     // done if Buddy is initialized by Spot.  Otherwise we prefer not
     // to overwrite a handler that might have been set by the user.)
@@ -94,12 +308,18 @@ namespace spot
       {
         bdd_gbc_hook(gbc_handler);
         bdd_resize_hook(resize_handler);
+        bdd_reorder_hook(reorder_handler);
         std::cerr << "spot: BDD package initialized\n";
         show_bdd_stats();
+        // Other threads may initialize their own BDD manager, but
+        // the final stats are only those of the thread that exits.
+        static bool registered = !std::atexit(show_final_bdd_stats);
+        (void) registered;
       }
     else
       {
         bdd_gbc_hook(nullptr);
+        bdd_reorder_hook(nullptr);
       }
   }
 
@@ -126,13 +346,30 @@ namespace spot
   int
   bdd_allocator::allocate_variables(int n)
   {
-    return register_n(n);
+#ifdef SPOT_ENABLE_PTHREAD
+    assert(owner_ == std::this_thread::get_id());
+#endif
+    int base = register_n(n);
+    if (SPOT_UNLIKELY(reordering().enabled) && n > 0)
+      {
+        add_range(base, base + n - 1);
+        rebuild_blocks();
+      }
+    return base;
   }
 
   void
   bdd_allocator::release_variables(int base, int n)
   {
+#ifdef SPOT_ENABLE_PTHREAD
+    assert(owner_ == std::this_thread::get_id());
+#endif
     release_n(base, n);
+    if (SPOT_UNLIKELY(reordering().enabled) && n > 0)
+      {
+        forget_range(base, base + n - 1);
+        rebuild_blocks();
+      }
   }
 
   int
@@ -1,6 +1,6 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013, 2016 Laboratoire de Recherche et Développement
-// de l'Epita (LRDE).
+// Copyright (C) 2013, 2016, 2018 Laboratoire de Recherche et
+// Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
 // et Marie Curie.
@@ -22,20 +22,28 @@
 
 #pragma once
 
+#include <spot/misc/_config.h>
 #include "spot/priv/freelist.hh"
 #include <list>
 #include <utility>
+#ifdef SPOT_ENABLE_PTHREAD
+#  include <thread>
+#endif
 
 namespace spot
 {
   /// \ingroup misc_tools
   /// \brief Manage ranges of variables.
+  ///
+  /// When Spot is configured with --enable-pthread, each thread has
+  /// its own BDD manager, and an allocator may only be used by the
+  /// thread that created it.
   class bdd_allocator: private free_list
   {
   public:
     /// Default constructor.
     bdd_allocator();
-    /// Initialize the BDD library.
+    /// Initialize the BDD library (for the calling thread).
     static void initialize();
     /// Allocate \a n BDD variables.
     int allocate_variables(int n);
@@ -44,7 +52,13 @@ namespace spot
 
     using free_list::dump_free_list;
   protected:
+#ifdef SPOT_ENABLE_PTHREAD
+    /// Whether the BDD library has been initialized in this thread.
+    static thread_local bool initialized;
+    std::thread::id owner_; ///< The thread that created this allocator.
+#else
     static bool initialized; ///< Whether the BDD library has been initialized.
+#endif
     int lvarnum; ///< number of variables in use in this allocator.
   private:
     /// Require more variables.
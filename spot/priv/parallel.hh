@@ -0,0 +1,96 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/misc/common.hh>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+// Building blocks for the parallel algorithms of Spot, in addition to
+// internal::parallel_threads() and internal::parallel_ranges() from
+// spot/misc/common.hh.  Remember that worker threads must not use the
+// BDD library (see spot::parallel_policy).
+
+namespace spot
+{
+  namespace internal
+  {
+    // Sort [begin,end) using nthreads threads.  Each thread sorts
+    // one slice, and the slices are then merged pairwise, in
+    // parallel.  This is not a stable sort, and it needs a buffer of
+    // the size of the input, so it is meant for small keys.
+    template <typename RandomIt, typename Compare>
+    void
+    parallel_sort(RandomIt begin, RandomIt end, Compare cmp,
+                  unsigned nthreads)
+    {
+      size_t n = end - begin;
+      if (nthreads <= 1 || n < 2)
+        {
+          std::sort(begin, end, cmp);
+          return;
+        }
+      std::vector<size_t> bounds(nthreads + 1);
+      for (unsigned i = 0; i <= nthreads; ++i)
+        bounds[i] = n * i / nthreads;
+      parallel_ranges(nthreads, n,
+                      [&](unsigned, size_t b, size_t e)
+                      {
+                        std::sort(begin + b, begin + e, cmp);
+                      });
+      typedef typename std::iterator_traits<RandomIt>::value_type value_t;
+      std::vector<value_t> buffer(n);
+      // The slices are alternately merged from the input into the
+      // buffer, and from the buffer into the input.
+      bool in_buffer = false;
+      while (bounds.size() > 2)
+        {
+          unsigned slices = bounds.size() - 1;
+          unsigned pairs = (slices + 1) / 2;
+          auto src = in_buffer ? buffer.begin() : begin;
+          auto dst = in_buffer ? begin : buffer.begin();
+          parallel_ranges(pairs, pairs,
+                          [&](unsigned, size_t pb, size_t pe)
+                          {
+                            for (size_t p = pb; p < pe; ++p)
+                              {
+                                size_t b = bounds[2 * p];
+                                size_t m = bounds[std::min<size_t>(2 * p + 1,
+                                                                   slices)];
+                                size_t e = bounds[std::min<size_t>(2 * p + 2,
+                                                                   slices)];
+                                std::merge(src + b, src + m, src + m, src + e,
+                                           dst + b, cmp);
+                              }
+                          });
+          std::vector<size_t> nb;
+          for (size_t i = 0; i < bounds.size(); i += 2)
+            nb.push_back(bounds[i]);
+          if (nb.back() != n)
+            nb.push_back(n);
+          bounds.swap(nb);
+          in_buffer = !in_buffer;
+        }
+      if (in_buffer)
+        std::copy(buffer.begin(), buffer.end(), begin);
+    }
+  }
+}
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2015, 2017 Laboratoire de Recherche et Développement de
+// Copyright (C) 2015, 2017, 2018 Laboratoire de Recherche et Développement de
 // l'Epita (LRDE).
 // Copyright (C) 2004, 2014  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -37,6 +37,8 @@ namespace spot
   public:
     /// Construct a empty vector (all counters set to zero).
     weight(const acc_cond& acc);
+    /// Construct a vector without counters, meant to be assigned.
+    weight() = default;
     /// Increment by one the counters of each acceptance condition in \a a.
     weight& add(acc_cond::mark_t a);
     /// Decrement by one the counters of each acceptance condition in \a a.
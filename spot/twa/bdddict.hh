@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011-2017 Laboratoire de Recherche et Développement
+// Copyright (C) 2011-2018 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 // Copyright (C) 2003, 2004, 2006 Laboratoire d'Informatique de Paris
 // 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
@@ -52,6 +52,13 @@ namespace spot
   /// unregister_all_my_variables(), giving the same pointer.
   /// Variables can also by unregistered one by one using
   /// unregister_variable().
+  ///
+  /// If Spot was configured with --enable-pthread, each thread has
+  /// its own BDD manager, and a bdd_dict is bound to the manager of
+  /// the thread that created it: the dictionary, and the automata
+  /// and BDDs that use it, must not be used by another thread.
+  /// Threads working on unrelated automata (each with their own
+  /// bdd_dict) do not need any synchronization.
   class SPOT_API bdd_dict
   {
     bdd_dict_priv* priv_;
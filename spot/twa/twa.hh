@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2009, 2011, 2013-2017 Laboratoire de Recherche et
+// Copyright (C) 2009, 2011, 2013-2018 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 // Copyright (C) 2003-2005 Laboratoire d'Informatique de Paris 6
 // (LIP6), département Systèmes Répartis Coopératifs (SRC), Université
@@ -196,11 +196,272 @@ namespace spot
   using state_map = std::unordered_map<const state*, val,
                                        state_ptr_hash, state_ptr_equal>;
 
+#ifndef SWIG
+  /// \ingroup twa_essentials
+  /// \brief Open-addressing hash table of abstract states
+  ///
+  /// This offers the subset of the interface of state_map<Val> used
+  /// by emptiness checks, but stores all entries in a single array
+  /// that is probed linearly.  The hash value of each state is
+  /// computed once and kept next to the state pointer: probing only
+  /// calls state::compare() on states with the same hash, and
+  /// growing the table never calls state::hash() again.
+  ///
+  /// Values are stored inline in the array, so unlike with
+  /// state_map, any insertion or erasure invalidates iterators and
+  /// pointers to values.  The state pointers themselves are never
+  /// moved, and should not be modified through an iterator.
+  /// Empty slots hold a default-constructed \a Val, so \a Val
+  /// should be default-constructible and move-assignable.
+  ///
+  /// Destroying each state if needed is the user's responsibility;
+  /// destroy_states() does it for all of them in a single pass.
+  template<class Val>
+  class state_store
+  {
+  public:
+    struct value_type
+    {
+      const state* first = nullptr;
+      Val second = Val();
+    };
+
+  private:
+    struct slot_t: public value_type
+    {
+      unsigned hash = 0;
+    };
+    // The size of this vector is either 0 or a power of 2.
+    std::vector<slot_t> slots_;
+    size_t size_ = 0;
+
+    template<class V, class S>
+    class iter_t
+    {
+      S* p_;
+      S* end_;
+
+      void skip_()
+      {
+        while (p_ != end_ && !p_->first)
+          ++p_;
+      }
+    public:
+      iter_t(S* p, S* end)
+        : p_(p), end_(end)
+      {
+        skip_();
+      }
+
+      V& operator*() const
+      {
+        return *p_;
+      }
+
+      V* operator->() const
+      {
+        return p_;
+      }
+
+      iter_t& operator++()
+      {
+        ++p_;
+        skip_();
+        return *this;
+      }
+
+      bool operator==(const iter_t& o) const
+      {
+        return p_ == o.p_;
+      }
+
+      bool operator!=(const iter_t& o) const
+      {
+        return p_ != o.p_;
+      }
+    };
+
+    static size_t home_(unsigned hash, size_t mask)
+    {
+      return wang32_hash(hash) & mask;
+    }
+
+    // Return the slot holding a state equal to S, or the empty
+    // slot where S should be inserted.
+    slot_t* probe_(const state* s, unsigned hash) const
+    {
+      size_t mask = slots_.size() - 1;
+      size_t i = home_(hash, mask);
+      for (;;)
+        {
+          const slot_t& sl = slots_[i];
+          if (!sl.first || (sl.hash == hash
+                            && (sl.first == s || sl.first->compare(s) == 0)))
+            return const_cast<slot_t*>(&sl);
+          i = (i + 1) & mask;
+        }
+    }
+
+    void grow_()
+    {
+      std::vector<slot_t> old;
+      old.swap(slots_);
+      slots_.resize(old.empty() ? 16 : 2 * old.size());
+      size_t mask = slots_.size() - 1;
+      for (auto& sl: old)
+        if (sl.first)
+          {
+            size_t i = home_(sl.hash, mask);
+            while (slots_[i].first)
+              i = (i + 1) & mask;
+            slots_[i] = std::move(sl);
+          }
+    }
+
+  public:
+    typedef iter_t<value_type, slot_t> iterator;
+    typedef iter_t<const value_type, const slot_t> const_iterator;
+
+    iterator begin()
+    {
+      return {slots_.data(), slots_.data() + slots_.size()};
+    }
+
+    iterator end()
+    {
+      auto e = slots_.data() + slots_.size();
+      return {e, e};
+    }
+
+    const_iterator begin() const
+    {
+      return {slots_.data(), slots_.data() + slots_.size()};
+    }
+
+    const_iterator end() const
+    {
+      auto e = slots_.data() + slots_.size();
+      return {e, e};
+    }
+
+    size_t size() const
+    {
+      return size_;
+    }
+
+    bool empty() const
+    {
+      return size_ == 0;
+    }
+
+    /// Find the entry of a state equal to \a s.
+    iterator find(const state* s)
+    {
+      if (!size_)
+        return end();
+      slot_t* sl = probe_(s, s->hash());
+      if (!sl->first)
+        return end();
+      return {sl, slots_.data() + slots_.size()};
+    }
+
+    const_iterator find(const state* s) const
+    {
+      if (!size_)
+        return end();
+      const slot_t* sl = probe_(s, s->hash());
+      if (!sl->first)
+        return end();
+      return {sl, slots_.data() + slots_.size()};
+    }
+
+    /// \brief Insert \a s, unless an equal state is already present.
+    ///
+    /// When \a s is inserted, its value is constructed from \a args.
+    /// Return an iterator to the entry of the state, and whether the
+    /// insertion took place.
+    template<class... Args>
+    std::pair<iterator, bool> emplace(const state* s, Args&&... args)
+    {
+      unsigned hash = s->hash();
+      if (2 * (size_ + 1) > slots_.size())
+        grow_();
+      slot_t* sl = probe_(s, hash);
+      bool inserted = !sl->first;
+      if (inserted)
+        {
+          sl->first = s;
+          sl->second = Val(std::forward<Args>(args)...);
+          sl->hash = hash;
+          ++size_;
+        }
+      return {{sl, slots_.data() + slots_.size()}, inserted};
+    }
+
+    /// Return the value of \a s, inserting it first if needed.
+    Val& operator[](const state* s)
+    {
+      return emplace(s).first->second;
+    }
+
+    /// Remove the entry of a state equal to \a s, if any, and
+    /// return the number of removed entries.
+    size_t erase(const state* s)
+    {
+      if (!size_)
+        return 0;
+      slot_t* sl = probe_(s, s->hash());
+      if (!sl->first)
+        return 0;
+      // Backward-shift deletion: fill the hole with any following
+      // entry of the cluster whose home slot does not lie
+      // (cyclically) after the hole.
+      size_t mask = slots_.size() - 1;
+      size_t i = sl - slots_.data();
+      size_t j = i;
+      for (;;)
+        {
+          j = (j + 1) & mask;
+          if (!slots_[j].first)
+            break;
+          size_t k = home_(slots_[j].hash, mask);
+          if (j > i ? (k <= i || k > j) : (k <= i && k > j))
+            {
+              slots_[i] = std::move(slots_[j]);
+              i = j;
+            }
+        }
+      slots_[i] = slot_t();
+      --size_;
+      return 1;
+    }
+
+    /// Remove all entries and release the memory of the table.
+    void clear()
+    {
+      std::vector<slot_t>().swap(slots_);
+      size_ = 0;
+    }
+
+    /// Destroy all states of the table, and clear it.
+    void destroy_states()
+    {
+      for (auto& sl: slots_)
+        if (sl.first)
+          sl.first->destroy();
+      clear();
+    }
+  };
+#endif
+
   /// \ingroup twa_essentials
   /// \brief Render state pointers unique via a hash table.
   class SPOT_API state_unicity_table
   {
-    state_set m;
+    struct none
+    {
+    };
+    state_store<none> m;
   public:
 
     /// \brief Canonicalize state pointer.
@@ -213,10 +474,10 @@ namespace spot
     /// destruction.
     const state* operator()(const state* s)
     {
-      auto p = m.insert(s);
+      auto p = m.emplace(s);
       if (!p.second)
         s->destroy();
-      return *p.first;
+      return p.first->first;
     }
 
     /// \brief Canonicalize state pointer.
@@ -225,24 +486,18 @@ namespace spot
     /// is returned if the state is not new.
     const state* is_new(const state* s)
     {
-      auto p = m.insert(s);
+      auto p = m.emplace(s);
       if (!p.second)
         {
           s->destroy();
           return nullptr;
         }
-      return *p.first;
+      return s;
     }
 
     ~state_unicity_table()
     {
-      for (state_set::iterator i = m.begin(); i != m.end();)
-        {
-          // Advance the iterator before destroying its key.  This
-          // avoid issues with old g++ implementations.
-          state_set::iterator old = i++;
-          (*old)->destroy();
-        }
+      m.destroy_states();
     }
 
     size_t
@@ -346,6 +601,15 @@ namespace spot
                              state_shared_ptr_hash,
                              state_shared_ptr_equal> shared_state_set;
 
+  /// \ingroup twa_essentials
+  /// \brief A successor, as stored by twa_succ_iterator::fill_succ().
+  struct SPOT_API twa_succ_entry
+  {
+    const state* dst;           ///< Destination, to be destroyed.
+    bdd cond;                   ///< Label of the edge.
+    acc_cond::mark_t acc;       ///< Acceptance marks of the edge.
+  };
+
   /// \ingroup twa_essentials
   /// \brief Iterate over the successors of a state.
   ///
@@ -394,6 +658,9 @@ namespace spot
   ///
   /// This loops uses the return value of first() and next() to save
   /// n+1 calls to done().
+  ///
+  /// Algorithms that need all successors of a state at once can
+  /// save even more calls by trying fill_succ() first.
   class SPOT_API twa_succ_iterator
   {
   public:
@@ -474,6 +741,42 @@ namespace spot
     virtual acc_cond::mark_t acc() const = 0;
 
     ///@}
+
+#ifndef SWIG
+    /// \name Bulk access
+    ///@{
+
+    /// \brief Append all successors to \a out.
+    ///
+    /// Iterators that support it append one entry per successor, in
+    /// the order in which first() and next() would visit them, using
+    /// a single virtual call instead of about four per successor.
+    /// As with dst(), the caller has to destroy the states stored in
+    /// \a out.
+    ///
+    /// After this call, the position of the iterator is unspecified:
+    /// call first() before iterating again.
+    ///
+    /// \return false if this iterator does not support bulk access
+    /// (this is the default), in which case \a out is left unchanged
+    /// and the successors should be iterated over as usual.
+    ///
+    /// This suits searches that handle all the successors of a state
+    /// right away, like the couvreur99 emptiness checks.  The nested
+    /// depth-first searches (magic, se05, tau03, tau03_opt, gv04) do
+    /// not use it: they may stop after the first successor of a
+    /// state, and each state on their stack has only one successor
+    /// alive at a time.  With fill_succ(), all the successors of all
+    /// the states on the stack would be built and kept until popped,
+    /// which defeats the purpose of bit-state hashing.
+    virtual bool fill_succ(std::vector<twa_succ_entry>& out)
+    {
+      (void) out;
+      return false;
+    }
+
+    ///@}
+#endif
   };
 
   namespace internal
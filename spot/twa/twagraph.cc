@@ -20,8 +20,12 @@
 #include <spot/twa/twagraph.hh>
 #include <spot/tl/print.hh>
 #include <spot/misc/bddlt.hh>
+#include <spot/priv/parallel.hh>
+#include <spot/misc/strpool.hh>
 #include <vector>
 #include <deque>
+#include <unordered_map>
+#include <algorithm>
 
 namespace spot
 {
@@ -46,6 +50,10 @@ namespace spot
     if (named && n < named->size())
       return (*named)[n];
 
+    auto pool = get_named_prop<string_pool>("state-name-pool");
+    if (pool && n < pool->size())
+      return pool->str(n);
+
     auto prod = get_named_prop
       <std::vector<std::pair<unsigned, unsigned>>>("product-states");
     if (prod && n < prod->size())
@@ -91,8 +99,8 @@ namespace spot
     auto& dests = g.dests_vector();
     auto& edges = g.edge_vector();
 
-    std::vector<unsigned> old_dests;
-    std::swap(dests, old_dests);
+    std::vector<unsigned> old_dests(dests.begin(), dests.end());
+    dests.clear();
     std::vector<unsigned> seen(old_dests.size(), -1U);
     internal::univ_dest_mapper<twa_graph::graph_t> uniq(g);
 
@@ -119,30 +127,141 @@ namespace spot
     fixup(init_number_);
   }
 
-  void twa_graph::merge_edges()
+  namespace
+  {
+    typedef twa_graph::graph_t::edge_storage_t tr_t;
+    typedef twa_graph::graph_t::edge_vector_t tr_vector_t;
+
+    // Sort the edges of trans by source, destination, and val(edge),
+    // using nthreads threads.  This is the parallel version of
+    // digraph::radix_sort_edges_().  Because the keys include the
+    // original position of the edges, the result matches that of a
+    // stable sort.  The edges are moved into a new vector so that
+    // worker threads only overwrite default-constructed edges, and
+    // never touch the reference count of a BDD.
+    template <typename Val>
+    void parallel_sort_edges(tr_vector_t& trans, unsigned nthreads, Val val)
+    {
+      unsigned tend = trans.size();
+      std::vector<internal::edge_sort_key> keys(tend - 1);
+      internal::parallel_ranges(nthreads, tend - 1,
+                                [&](unsigned, size_t b, size_t e)
+                                {
+                                  for (size_t i = b; i < e; ++i)
+                                    {
+                                      const tr_t& t = trans[i + 1];
+                                      keys[i] = {t.src, t.dst, val(t),
+                                                 unsigned(i + 1)};
+                                    }
+                                });
+      internal::parallel_sort(keys.begin(), keys.end(),
+                              std::less<internal::edge_sort_key>(),
+                              nthreads);
+      tr_vector_t sorted(trans.get_allocator());
+      sorted.reserve(tend);
+      sorted.emplace_back(std::move(trans[0]));
+      sorted.resize(tend);
+      internal::parallel_ranges(nthreads, tend - 1,
+                                [&](unsigned, size_t b, size_t e)
+                                {
+                                  for (size_t i = b; i < e; ++i)
+                                    sorted[i + 1] =
+                                      std::move(trans[keys[i].pos]);
+                                });
+      trans.swap(sorted);
+    }
+
+    // Merge consecutive edges with the same source, destination, and
+    // condition, using nthreads threads.  The ranges processed by
+    // each thread are aligned on groups of mergeable edges.
+    void parallel_merge_acc(tr_vector_t& trans, unsigned nthreads)
+    {
+      auto same = [](const tr_t& a, const tr_t& b)
+        {
+          return (a.dst == b.dst && a.cond.id() == b.cond.id()
+                  && a.src == b.src);
+        };
+      unsigned tend = trans.size();
+      std::vector<unsigned> bounds;
+      bounds.reserve(nthreads + 1);
+      bounds.push_back(1);
+      for (unsigned i = 1; i < nthreads; ++i)
+        {
+          unsigned b = std::max(bounds.back(),
+                                unsigned(1 + (tend - 1ULL) * i / nthreads));
+          while (b > 1 && b < tend && same(trans[b - 1], trans[b]))
+            ++b;
+          bounds.push_back(b);
+        }
+      bounds.push_back(tend);
+
+      // First, merge the acceptance marks of each group into its
+      // first edge, and count the groups of each range.
+      std::vector<unsigned> first(nthreads + 1);
+      internal::parallel_ranges(nthreads, nthreads,
+                                [&](unsigned, size_t rb, size_t re)
+                                {
+                                  for (size_t r = rb; r < re; ++r)
+                                    {
+                                      unsigned n = 0;
+                                      unsigned h = 0;
+                                      for (unsigned t = bounds[r];
+                                           t < bounds[r + 1]; ++t)
+                                        if (n && same(trans[h], trans[t]))
+                                          {
+                                            trans[h].acc |= trans[t].acc;
+                                          }
+                                        else
+                                          {
+                                            h = t;
+                                            ++n;
+                                          }
+                                      first[r + 1] = n;
+                                    }
+                                });
+      first[0] = 1;
+      for (unsigned i = 0; i < nthreads; ++i)
+        first[i + 1] += first[i];
+
+      // Then move the first edge of each group.
+      tr_vector_t merged(trans.get_allocator());
+      merged.reserve(first[nthreads]);
+      merged.emplace_back(std::move(trans[0]));
+      merged.resize(first[nthreads]);
+      internal::parallel_ranges(nthreads, nthreads,
+                                [&](unsigned, size_t rb, size_t re)
+                                {
+                                  for (size_t r = rb; r < re; ++r)
+                                    {
+                                      unsigned out = first[r];
+                                      for (unsigned t = bounds[r];
+                                           t < bounds[r + 1]; ++t)
+                                        if (out == first[r]
+                                            || !same(merged[out - 1],
+                                                     trans[t]))
+                                          merged[out++] = std::move(trans[t]);
+                                    }
+                                });
+      trans.swap(merged);
+    }
+  }
+
+  void twa_graph::merge_edges(parallel_policy ppolicy)
   {
     set_named_prop("highlight-edges", nullptr);
     g_.remove_dead_edges_();
     if (!is_existential())
       merge_univ_dests();
 
-    typedef graph_t::edge_storage_t tr_t;
-    g_.sort_edges_([](const tr_t& lhs, const tr_t& rhs)
-                   {
-                     if (lhs.src < rhs.src)
-                       return true;
-                     if (lhs.src > rhs.src)
-                       return false;
-                     if (lhs.dst < rhs.dst)
-                       return true;
-                     if (lhs.dst > rhs.dst)
-                       return false;
-                     return lhs.acc < rhs.acc;
-                     // Do not sort on conditions, we'll merge
-                     // them.
-                   });
-
     auto& trans = this->edge_vector();
+    unsigned nthreads = internal::parallel_threads(ppolicy, trans.size());
+    if (nthreads > 1)
+      parallel_sort_edges(trans, nthreads,
+                          [](const tr_t& t) { return t.acc.id; });
+    else
+      // Do not sort on conditions, we'll merge them.
+      g_.radix_sort_edges_([](const tr_t& t) { return t.acc.id; });
+
     unsigned tend = trans.size();
     unsigned out = 0;
     unsigned in = 1;
@@ -153,7 +272,7 @@ namespace spot
       {
         ++out;
         if (out != in)
-          trans[out] = trans[in];
+          trans[out] = std::move(trans[in]);
         for (++in; in < tend; ++in)
           {
             if (trans[in].cond == bddfalse) // Unusable edge
@@ -172,7 +291,7 @@ namespace spot
               {
                 ++out;
                 if (in != out)
-                  trans[out] = trans[in];
+                  trans[out] = std::move(trans[in]);
               }
           }
       }
@@ -180,7 +299,8 @@ namespace spot
       trans.resize(out);
 
     tend = out;
-    out = in = 2;
+    out = 1;
+    in = 2;
 
     // FIXME: We could should also merge edges when using
     // fin_acceptance, but the rule for Fin sets are different than
@@ -188,22 +308,89 @@ namespace spot
     // both as Inf and Fin)
     if ((in < tend) && !acc().uses_fin_acceptance())
       {
-        typedef graph_t::edge_storage_t tr_t;
-        g_.sort_edges_([](const tr_t& lhs, const tr_t& rhs)
-                       {
-                         if (lhs.src < rhs.src)
-                           return true;
-                         if (lhs.src > rhs.src)
-                           return false;
-                         if (lhs.dst < rhs.dst)
-                           return true;
-                         if (lhs.dst > rhs.dst)
-                           return false;
-                         bdd_less_than_stable lt;
-                         return lt(lhs.cond, rhs.cond);
-                         // Do not sort on acceptance, we'll merge
-                         // them.
-                       });
+        // After the first pass, edges with the same source and
+        // destination are consecutive, so it is enough to sort each
+        // of these groups by condition.  Comparing BDDs with
+        // bdd_less_than_stable is costly, but automata usually reuse
+        // a few conditions on many edges.  In that case, we collect
+        // the distinct conditions of these groups in a temporary
+        // table, sort this table once, and sort the groups on the
+        // ranks of their conditions in this table.  Only these ranks
+        // can be used by the parallel version.
+        auto group_end = [&](unsigned b)
+          {
+            unsigned e = b + 1;
+            while (e < tend && trans[e].dst == trans[b].dst
+                   && trans[e].src == trans[b].src)
+              ++e;
+            return e;
+          };
+        std::unordered_map<int, unsigned> label_rank;
+        std::vector<bdd> labels;
+        // Give up on ranking as soon as it is clear that the
+        // conditions are not reused at least 8 times on average.
+        unsigned max_labels = tend / 8;
+        unsigned grouped = 0;
+        for (unsigned b = 1, e; b < tend && labels.size() <= max_labels; b = e)
+          {
+            e = group_end(b);
+            if (e - b < 2)
+              continue;
+            grouped += e - b;
+            for (unsigned t = b; t < e; ++t)
+              if (label_rank.emplace(trans[t].cond.id(), 0).second)
+                labels.emplace_back(trans[t].cond);
+          }
+        bool ranked = labels.size() * 8 <= grouped;
+        if (ranked)
+          {
+            std::sort(labels.begin(), labels.end(), bdd_less_than_stable());
+            unsigned rank = 0;
+            for (auto& l: labels)
+              label_rank[l.id()] = rank++;
+          }
+        labels.clear();
+        if (ranked && nthreads > 1)
+          {
+            // Because the edges are already sorted by source and
+            // destination, this sort only reorders the groups.
+            parallel_sort_edges(trans, nthreads,
+                                [&](const tr_t& t)
+                                {
+                                  // Conditions of single edges have
+                                  // not been ranked.
+                                  auto i = label_rank.find(t.cond.id());
+                                  return (i == label_rank.end()
+                                          ? 0U : i->second);
+                                });
+            parallel_merge_acc(trans, nthreads);
+            g_.chain_edges_();
+            return;
+          }
+        for (unsigned b = 1, e; b < tend; b = e)
+          {
+            e = group_end(b);
+            if (e - b < 2)
+              continue;
+            auto gb = trans.begin() + b;
+            auto ge = trans.begin() + e;
+            if (ranked)
+              std::stable_sort(gb, ge,
+                               [&](const tr_t& lhs, const tr_t& rhs)
+                               {
+                                 return (label_rank.at(lhs.cond.id())
+                                         < label_rank.at(rhs.cond.id()));
+                               });
+            else
+              std::stable_sort(gb, ge,
+                               [](const tr_t& lhs, const tr_t& rhs)
+                               {
+                                 bdd_less_than_stable lt;
+                                 return lt(lhs.cond, rhs.cond);
+                                 // Do not sort on acceptance, we'll
+                                 // merge them.
+                               });
+          }
 
         for (; in < tend; ++in)
           {
@@ -220,7 +407,7 @@ namespace spot
               {
                 ++out;
                 if (in != out)
-                  trans[out] = trans[in];
+                  trans[out] = std::move(trans[in]);
               }
           }
         if (++out != tend)
@@ -230,7 +417,7 @@ namespace spot
     g_.chain_edges_();
   }
 
-  void twa_graph::purge_unreachable_states()
+  void twa_graph::purge_unreachable_states(parallel_policy ppolicy)
   {
     unsigned num_states = g_.num_states();
     // The TODO vector serves two purposes:
@@ -279,10 +466,10 @@ namespace spot
     if (prop_complete().is_false())
       prop_complete(trival::maybe());
 
-    defrag_states(std::move(todo), current);
+    defrag_states(std::move(todo), current, ppolicy);
   }
 
-  void twa_graph::purge_dead_states()
+  void twa_graph::purge_dead_states(parallel_policy ppolicy)
   {
     unsigned num_states = g_.num_states();
     std::vector<unsigned> useful(num_states, 0);
@@ -476,14 +663,15 @@ namespace spot
     if (prop_complete().is_false())
       prop_complete(trival::maybe());
 
-    defrag_states(std::move(useful), current);
+    defrag_states(std::move(useful), current, ppolicy);
 
     if (purge_unreachable_needed)
-      purge_unreachable_states();
+      purge_unreachable_states(ppolicy);
   }
 
   void twa_graph::defrag_states(std::vector<unsigned>&& newst,
-                                unsigned used_states)
+                                unsigned used_states,
+                                parallel_policy ppolicy)
   {
     if (!is_existential())
       {
@@ -512,8 +700,8 @@ namespace spot
         auto& dests = g.dests_vector();
 
         // Clear the destination vector, saving the old one.
-        std::vector<unsigned> old_dests;
-        std::swap(dests, old_dests);
+        std::vector<unsigned> old_dests(dests.begin(), dests.end());
+        dests.clear();
         // dests will be updated as a side effect of declaring new
         // destination groups to uniq.
         internal::univ_dest_mapper<twa_graph::graph_t> uniq(g);
@@ -585,6 +773,8 @@ namespace spot
           }
         names->resize(used_states);
       }
+    if (auto* pool = get_named_prop<string_pool>("state-name-pool"))
+      *pool = pool->renumbered(newst, used_states);
     if (auto hs = get_named_prop<std::map<unsigned, unsigned>>
         ("highlight-states"))
       {
@@ -634,7 +824,7 @@ namespace spot
           }
       }
     init_number_ = newst[init_number_];
-    g_.defrag_states(std::move(newst), used_states);
+    g_.defrag_states(std::move(newst), used_states, ppolicy);
   }
 
   void twa_graph::remove_unused_ap()
@@ -729,7 +919,7 @@ namespace spot
       out->copy_ap_of(aut);
       out->prop_copy(aut, p);
 
-      std::vector<std::string>* names = nullptr;
+      string_pool* names = nullptr;
       std::set<unsigned>* incomplete = nullptr;
 
       // Old highlighting maps
@@ -743,8 +933,8 @@ namespace spot
 
       if (preserve_names)
         {
-          names = new std::vector<std::string>;
-          out->set_named_prop("state-names", names);
+          names = new string_pool;
+          out->set_named_prop("state-name-pool", names);
 
           // If the input is a twa_graph and we were asked to preserve
           // names, also preserve highlights.
@@ -773,7 +963,7 @@ namespace spot
               p.first->second = out->new_state();
               todo.emplace_back(p.first);
               if (names)
-                names->emplace_back(aut->format_state(s));
+                names->push_back(aut->format_state(s));
               if (ohstates)
                 {
                   auto q = ohstates->find(aut_g->state_number(s));
@@ -93,7 +93,7 @@ namespace spot
     }
 
     twa_graph_edge_data(bdd cond, acc_cond::mark_t acc = 0U) noexcept
-      : cond(cond), acc(acc)
+      : cond(std::move(cond)), acc(acc)
     {
     }
 
@@ -176,6 +176,18 @@ namespace spot
       return g_->edge_data(p_).acc;
     }
 
+#ifndef SWIG
+    virtual bool fill_succ(std::vector<twa_succ_entry>& out) override
+    {
+      for (edge e = t_; e; e = g_->edge_storage(e).next_succ)
+        {
+          auto& t = g_->edge_storage(e);
+          out.push_back({&g_->state_data(t.dst), t.cond, t.acc});
+        }
+      return true;
+    }
+#endif
+
     edge pos() const
     {
       return p_;
@@ -466,6 +478,40 @@ namespace spot
       return g_.out(src);
     }
 
+#ifndef SWIG
+    internal::frozen_state_out<const graph_t>
+    frozen_out(unsigned src) const
+    {
+      return g_.frozen_out(src);
+    }
+
+    internal::frozen_state_out<graph_t>
+    frozen_out(unsigned src)
+    {
+      return g_.frozen_out(src);
+    }
+#endif
+
+    /// \brief Store the outgoing edges of each state consecutively.
+    ///
+    /// This is meant to be called on large automata that will be
+    /// traversed many times, but no longer modified.  See
+    /// digraph::freeze() for details.  If edges have to be
+    /// renumbered, the "highlight-edges" property is removed.
+    void freeze()
+    {
+      if (g_.freeze())
+        set_named_prop("highlight-edges", nullptr);
+    }
+
+    /// \brief Whether the automaton is frozen.
+    ///
+    /// \see freeze()
+    bool is_frozen() const
+    {
+      return g_.is_frozen();
+    }
+
     internal::const_universal_dests
     univ_dests(unsigned d) const noexcept
     {
@@ -541,7 +587,11 @@ namespace spot
     ///
     /// If the automaton uses some universal edges, the method
     /// merge_univ_dests() is also called.
-    void merge_edges();
+    ///
+    /// On large automata, the sorting of the edges, and the second
+    /// pass when conditions are reused enough, can use the number of
+    /// threads allowed by \a ppolicy.
+    void merge_edges(parallel_policy ppolicy = parallel_policy());
 
     /// \brief Merge common universal destinations.
     ///
@@ -562,8 +612,12 @@ namespace spot
     /// dead, but this might cause the other destinations to become
     /// dead or unreachable themselves.)
     ///
+    /// The final renumbering of states and edges can use the number
+    /// of threads allowed by \a ppolicy, if the automaton is large
+    /// enough.
+    ///
     /// \see purge_unreachable_states
-    void purge_dead_states();
+    void purge_dead_states(parallel_policy ppolicy = parallel_policy());
 
     /// \brief Remove all unreachable states.
     ///
@@ -576,8 +630,12 @@ namespace spot
     /// purge_dead_states() will remove more states than
     /// purge_unreachable_states(), but it is more costly.
     ///
+    /// As in purge_dead_states(), \a ppolicy is used only for the
+    /// final renumbering.
+    ///
     /// \see purge_dead_states
-    void purge_unreachable_states();
+    void
+    purge_unreachable_states(parallel_policy ppolicy = parallel_policy());
 
     /// \brief Remove unused atomic propositions
     ///
@@ -660,7 +718,10 @@ namespace spot
     /// \param newst A vector indicating how each state should be renumbered.
     /// Use -1U to erase a state.
     /// \param used_states the number of states used (after renumbering)
-    void defrag_states(std::vector<unsigned>&& newst, unsigned used_states);
+    /// \param ppolicy the number of threads that may be used to
+    /// renumber the edges, if there are enough of them.
+    void defrag_states(std::vector<unsigned>&& newst, unsigned used_states,
+                       parallel_policy ppolicy = parallel_policy());
   };
 
   /// \ingroup twa_representation
@@ -691,7 +752,8 @@ namespace spot
   ///
   /// This overload works using the abstract interface for automata.
   ///
-  /// Set \a preserve_names to preserve state names, and set \a max_states
+  /// Set \a preserve_names to preserve state names (they are stored
+  /// in the "state-name-pool" named property), and set \a max_states
   /// to a maximum number of states to keep.  States with successors that
   /// have not been kept will be marked as incomplete; this is mostly useful
   /// to display a subset of a large state space.
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2009, 2011, 2012, 2014, 2015, 2016, 2017 Laboratoire
+// Copyright (C) 2009, 2011, 2012, 2014-2018 Laboratoire
 // de Recherche et Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004, 2006 Laboratoire d'Informatique de
 // Paris 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
@@ -21,6 +21,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <spot/twa/twaproduct.hh>
+#include <spot/twa/twagraph.hh>
 #include <string>
 #include <cassert>
 #include <spot/misc/hashfunc.hh>
@@ -77,6 +78,17 @@ namespace spot
 
   namespace
   {
+    // Append all successors of IT to OUT, in bulk if IT supports it.
+    void collect_succ(twa_succ_iterator* it,
+                      std::vector<twa_succ_entry>& out)
+    {
+      if (it->fill_succ(out))
+        return;
+      if (it->first())
+        do
+          out.push_back({it->dst(), it->cond(), it->acc()});
+        while (it->next());
+    }
 
     class twa_succ_iterator_product_common: public twa_succ_iterator
     {
@@ -84,8 +96,11 @@ namespace spot
       twa_succ_iterator_product_common(twa_succ_iterator* left,
                                         twa_succ_iterator* right,
                                         const twa_product* prod,
-                                        fixed_size_pool* pool)
-        : left_(left), right_(right), prod_(prod), pool_(pool)
+                                        fixed_size_pool* pool,
+                                        const twa_graph* left_graph,
+                                        const twa_graph* right_graph)
+        : left_(left), right_(right), prod_(prod), pool_(pool),
+          left_graph_(left_graph), right_graph_(right_graph)
       {
       }
 
@@ -129,18 +144,70 @@ namespace spot
         return !right_ || right_->done();
       }
 
-      const state_product* dst() const override
+      const state* dst() const override
       {
+        if (left_graph_)
+          return new(pool_->allocate())
+            state_product_packed(left_graph_->state_number(left_->dst()),
+                                 right_graph_->state_number(right_->dst()),
+                                 pool_);
         return new(pool_->allocate()) state_product(left_->dst(),
                                                     right_->dst(),
                                                     pool_);
       }
 
     protected:
+      // Collect the successors of both sides into lsucc_ and
+      // rsucc_, for fill_succ().  Return false if the product has
+      // no successor.  Either way, release_() should be called once
+      // the successors have been used.
+      bool collect_()
+      {
+        lsucc_.clear();
+        rsucc_.clear();
+        if (!right_)
+          return false;
+        collect_succ(left_, lsucc_);
+        if (lsucc_.empty())
+          return false;
+        collect_succ(right_, rsucc_);
+        return !rsucc_.empty();
+      }
+
+      const state* make_dst_(const twa_succ_entry& l,
+                             const twa_succ_entry& r) const
+      {
+        if (left_graph_)
+          return new(pool_->allocate())
+            state_product_packed(left_graph_->state_number(l.dst),
+                                 right_graph_->state_number(r.dst),
+                                 pool_);
+        return new(pool_->allocate()) state_product(l.dst->clone(),
+                                                    r.dst->clone(),
+                                                    pool_);
+      }
+
+      // Destroy the states of lsucc_ and rsucc_, once fill_succ()
+      // has cloned those it needed.  (States of a twa_graph need not
+      // be destroyed.)
+      void release_()
+      {
+        if (left_graph_)
+          return;
+        for (auto& l: lsucc_)
+          l.dst->destroy();
+        for (auto& r: rsucc_)
+          r.dst->destroy();
+      }
+
       twa_succ_iterator* left_;
       twa_succ_iterator* right_;
       const twa_product* prod_;
       fixed_size_pool* pool_;
+      const twa_graph* left_graph_;
+      const twa_graph* right_graph_;
+      std::vector<twa_succ_entry> lsucc_;
+      std::vector<twa_succ_entry> rsucc_;
       friend class spot::twa_product;
     };
 
@@ -153,8 +220,11 @@ namespace spot
       twa_succ_iterator_product(twa_succ_iterator* left,
                                  twa_succ_iterator* right,
                                  const twa_product* prod,
-                                 fixed_size_pool* pool)
-        : twa_succ_iterator_product_common(left, right, prod, pool)
+                                 fixed_size_pool* pool,
+                                 const twa_graph* left_graph,
+                                 const twa_graph* right_graph)
+        : twa_succ_iterator_product_common(left, right, prod, pool,
+                                           left_graph, right_graph)
       {
       }
 
@@ -206,6 +276,26 @@ namespace spot
         return left_->acc() | (right_->acc() << prod_->left_acc().num_sets());
       }
 
+      bool fill_succ(std::vector<twa_succ_entry>& out) override
+      {
+        if (collect_())
+          {
+            unsigned shift = prod_->left_acc().num_sets();
+            // The right successors are in the outer loop, as in
+            // step_().
+            for (auto& r: rsucc_)
+              for (auto& l: lsucc_)
+                {
+                  bdd cond = l.cond & r.cond;
+                  if (cond != bddfalse)
+                    out.push_back({make_dst_(l, r), cond,
+                                   l.acc | (r.acc << shift)});
+                }
+          }
+        release_();
+        return true;
+      }
+
     protected:
       bdd current_cond_;
     };
@@ -220,7 +310,8 @@ namespace spot
                                         twa_succ_iterator* right,
                                         const twa_product* prod,
                                         fixed_size_pool* pool)
-        : twa_succ_iterator_product_common(left, right, prod, pool)
+        : twa_succ_iterator_product_common(left, right, prod, pool,
+                                           nullptr, nullptr)
       {
       }
 
@@ -269,10 +360,38 @@ namespace spot
         return right_->acc();
       }
 
+      bool fill_succ(std::vector<twa_succ_entry>& out) override
+      {
+        if (collect_())
+          {
+            // All the transitions of left_ iterator have the
+            // same label, because it is a Kripke structure.
+            bdd lcond = lsucc_.front().cond;
+            for (auto& r: rsucc_)
+              {
+                bdd cond = lcond & r.cond;
+                if (cond != bddfalse)
+                  for (auto& l: lsucc_)
+                    out.push_back({make_dst_(l, r), cond, r.acc});
+              }
+          }
+        release_();
+        return true;
+      }
+
     protected:
       bdd current_cond_;
     };
 
+    // Return A as a twa_graph if both A and B are twa_graph.
+    const twa_graph* graph_operand(const const_twa_ptr& a,
+                                   const const_twa_ptr& b)
+    {
+      if (!dynamic_cast<const twa_graph*>(b.get()))
+        return nullptr;
+      return dynamic_cast<const twa_graph*>(a.get());
+    }
+
   } // anonymous
 
   ////////////////////////////////////////////////////////////
@@ -281,7 +400,10 @@ namespace spot
   twa_product::twa_product(const const_twa_ptr& left,
                            const const_twa_ptr& right)
     : twa(left->get_dict()), left_(left), right_(right),
-      pool_(sizeof(state_product))
+      left_graph_(graph_operand(left, right)),
+      right_graph_(graph_operand(right, left)),
+      pool_(left_graph_ ?
+            sizeof(state_product_packed) : sizeof(state_product))
   {
     if (left->get_dict() != right->get_dict())
       throw std::runtime_error("twa_product: left and right automata should "
@@ -327,16 +449,40 @@ namespace spot
   twa_product::get_init_state() const
   {
     fixed_size_pool* p = const_cast<fixed_size_pool*>(&pool_);
+    if (left_graph_)
+      return new(p->allocate())
+        state_product_packed(left_graph_->get_init_state_number(),
+                             right_graph_->get_init_state_number(), p);
     return new(p->allocate()) state_product(left_->get_init_state(),
                                             right_->get_init_state(), p);
   }
 
+  void
+  twa_product::split_state_(const state* s,
+                            const state*& left, const state*& right) const
+  {
+    if (left_graph_)
+      {
+        auto p = down_cast<const state_product_packed*>(s);
+        left = left_graph_->state_from_number(p->left());
+        right = right_graph_->state_from_number(p->right());
+      }
+    else
+      {
+        auto p = down_cast<const state_product*>(s);
+        left = p->left();
+        right = p->right();
+      }
+  }
+
   twa_succ_iterator*
   twa_product::succ_iter(const state* state) const
   {
-    const state_product* s = down_cast<const state_product*>(state);
-    twa_succ_iterator* li = left_->succ_iter(s->left());
-    twa_succ_iterator* ri = right_->succ_iter(s->right());
+    const spot::state* l;
+    const spot::state* r;
+    split_state_(state, l, r);
+    twa_succ_iterator* li = left_->succ_iter(l);
+    twa_succ_iterator* ri = right_->succ_iter(r);
 
     if (iter_cache_)
       {
@@ -351,7 +497,8 @@ namespace spot
     if (left_kripke_)
       return new twa_succ_iterator_product_kripke(li, ri, this, p);
     else
-      return new twa_succ_iterator_product(li, ri, this, p);
+      return new twa_succ_iterator_product(li, ri, this, p,
+                                           left_graph_, right_graph_);
   }
 
   const acc_cond& twa_product::left_acc() const
@@ -367,22 +514,24 @@ namespace spot
   std::string
   twa_product::format_state(const state* state) const
   {
-    const state_product* s = down_cast<const state_product*>(state);
-    return (left_->format_state(s->left())
-            + " * "
-            + right_->format_state(s->right()));
+    const spot::state* l;
+    const spot::state* r;
+    split_state_(state, l, r);
+    return left_->format_state(l) + " * " + right_->format_state(r);
   }
 
   state*
   twa_product::project_state(const state* s, const const_twa_ptr& t) const
   {
-    const state_product* s2 = down_cast<const state_product*>(s);
     if (t.get() == this)
-      return s2->clone();
-    state* res = left_->project_state(s2->left(), t);
+      return s->clone();
+    const state* l;
+    const state* r;
+    split_state_(s, l, r);
+    state* res = left_->project_state(l, t);
     if (res)
       return res;
-    return right_->project_state(s2->right(), t);
+    return right_->project_state(r, t);
   }
 
   //////////////////////////////////////////////////////////////////////
@@ -403,6 +552,10 @@ namespace spot
   twa_product_init::get_init_state() const
   {
     fixed_size_pool* p = const_cast<fixed_size_pool*>(&pool_);
+    if (left_graph_)
+      return new(p->allocate())
+        state_product_packed(left_graph_->state_number(left_init_),
+                             right_graph_->state_number(right_init_), p);
     return new(p->allocate()) state_product(left_init_->clone(),
                                             right_init_->clone(), p);
   }
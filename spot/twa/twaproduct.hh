@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2013, 2014, 2015, 2016 Laboratoire de Recherche
+// Copyright (C) 2011, 2013-2016, 2018 Laboratoire de Recherche
 // et Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004, 2006 Laboratoire d'Informatique de Paris
 // 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
@@ -24,6 +24,8 @@
 
 #include <spot/twa/twa.hh>
 #include <spot/misc/fixpool.hh>
+#include <spot/misc/hashfunc.hh>
+#include <cstdint>
 
 namespace spot
 {
@@ -77,8 +79,85 @@ namespace spot
     state_product(const state_product& o) = delete;
   };
 
+  /// \ingroup twa_on_the_fly_algorithms
+  /// \brief A state for spot::twa_product of two spot::twa_graph.
+  ///
+  /// The states of a twa_graph are identified by their numbers, so
+  /// this state only stores the numbers of the left and right
+  /// states, packed in a single integer.  Comparing or hashing two
+  /// such states does not call any method of the operands' states,
+  /// and orders them as state_product would.
+  class SPOT_API state_product_packed final: public state
+  {
+  public:
+    /// \brief Constructor
+    /// \param left The number of the state of the left automaton.
+    /// \param right The number of the state of the right automaton.
+    /// \param pool The pool from which the state was allocated.
+    state_product_packed(unsigned left, unsigned right,
+                         fixed_size_pool* pool)
+      : pair_((static_cast<std::uint64_t>(left) << 32) | right),
+        count_(1), pool_(pool)
+    {
+    }
+
+    virtual void destroy() const override
+    {
+      if (--count_)
+        return;
+      fixed_size_pool* p = pool_;
+      this->~state_product_packed();
+      p->deallocate(this);
+    }
+
+    unsigned
+    left() const
+    {
+      return pair_ >> 32;
+    }
+
+    unsigned
+    right() const
+    {
+      return static_cast<unsigned>(pair_);
+    }
+
+    virtual int compare(const state* other) const override
+    {
+      auto o = down_cast<const state_product_packed*>(other)->pair_;
+      return (pair_ > o) - (pair_ < o);
+    }
+
+    virtual size_t hash() const override
+    {
+      // Unlike state_product, do not combine both hashes with a
+      // plain XOR: it would map (l,r) and (r,l) to the same value.
+      return wang32_hash(wang32_hash(left()) ^ right());
+    }
+
+    virtual state_product_packed* clone() const override
+    {
+      ++count_;
+      return const_cast<state_product_packed*>(this);
+    }
+
+  private:
+    std::uint64_t pair_;
+    mutable unsigned count_;
+    fixed_size_pool* pool_;
+
+    virtual ~state_product_packed()
+    {
+    }
+    state_product_packed(const state_product_packed& o) = delete;
+  };
+
 
   /// \brief A lazy product.  (States are computed on the fly.)
+  ///
+  /// When both operands are spot::twa_graph, the states of the
+  /// product are spot::state_product_packed instances.  Otherwise
+  /// they are spot::state_product instances.
   class SPOT_API twa_product: public twa
   {
   public:
@@ -107,8 +186,15 @@ namespace spot
     const_twa_ptr left_;
     const_twa_ptr right_;
     bool left_kripke_;
+    // Both set if left_ and right_ are twa_graph, both null otherwise.
+    const twa_graph* left_graph_;
+    const twa_graph* right_graph_;
     fixed_size_pool pool_;
 
+    // Return the states of left_ and right_ that make up \a s.
+    void split_state_(const state* s,
+                      const state*& left, const state*& right) const;
+
   private:
     // Disallow copy.
     twa_product(const twa_product&) = delete;
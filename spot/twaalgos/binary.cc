@@ -0,0 +1,603 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <spot/misc/strpool.hh>
+#include <spot/twa/twagraph.hh>
+#include <spot/twaalgos/binary.hh>
+
+namespace spot
+{
+  namespace
+  {
+    // Each automaton is stored as a header followed by arrays of
+    // 32-bit words, in this order:
+    //  - the names of the atomic propositions,
+    //  - the BDD nodes, as (AP number, low, high) triples, where
+    //    0 and 1 denote the constants and n+2 denotes the nth node,
+    //  - the edge labels, as node references,
+    //  - the acceptance code,
+    //  - the initial states,
+    //  - num_states+1 offsets: the outgoing edges of state s are
+    //    numbered from offset[s] to offset[s+1]-1,
+    //  - the edges, as (destination, label number, mark) triples,
+    //  - the destination groups of universal edges,
+    //  - the optional names.
+    // Strings are stored as a length followed by their characters,
+    // padded to a multiple of 4 bytes.
+    const char binary_magic[8] = { 'S', 'P', 'O', 'T', 'B', 'I', 'N', 1 };
+    const uint32_t binary_byte_order = 0x01020304;
+
+    enum binary_flags : uint32_t
+    {
+      has_name = 1,
+      has_state_names = 2,
+    };
+
+    struct binary_header
+    {
+      char magic[8];
+      uint64_t size;            // Size of the record in bytes.
+      uint32_t byte_order;
+      uint32_t num_aps;
+      uint32_t num_nodes;
+      uint32_t num_labels;
+      uint32_t num_states;
+      uint32_t num_edges;
+      uint32_t num_init;
+      uint32_t num_sets;
+      uint32_t acc_size;
+      uint32_t num_dests;
+      uint32_t flags;
+      trival::repr_t props[12];
+    };
+    static_assert(sizeof(binary_header) % 4 == 0,
+                  "binary_header should be a multiple of 4 bytes");
+    static_assert(sizeof(acc_cond::acc_word) == 4,
+                  "acc_word are expected to be 4 bytes");
+
+    constexpr size_t header_words = sizeof(binary_header) / 4;
+
+    trival (twa::* const prop_getters[])() const =
+      {
+        &twa::prop_state_acc,
+        &twa::prop_inherently_weak,
+        &twa::prop_weak,
+        &twa::prop_terminal,
+        &twa::prop_very_weak,
+        &twa::prop_complete,
+        &twa::prop_universal,
+        &twa::prop_unambiguous,
+        &twa::prop_semi_deterministic,
+        &twa::prop_stutter_invariant,
+      };
+    void (twa::* const prop_setters[])(trival) =
+      {
+        &twa::prop_state_acc,
+        &twa::prop_inherently_weak,
+        &twa::prop_weak,
+        &twa::prop_terminal,
+        &twa::prop_very_weak,
+        &twa::prop_complete,
+        &twa::prop_universal,
+        &twa::prop_unambiguous,
+        &twa::prop_semi_deterministic,
+        &twa::prop_stutter_invariant,
+      };
+    constexpr unsigned num_props =
+      sizeof(prop_getters) / sizeof(*prop_getters);
+    static_assert(num_props <= sizeof(binary_header::props),
+                  "not enough room for properties");
+
+    class binary_writer final
+    {
+      std::vector<uint32_t>& out_;
+      std::vector<unsigned> ap_of_var_;
+      std::unordered_map<int, unsigned> node_num_;
+      std::vector<uint32_t> nodes_;
+
+    public:
+      binary_writer(std::vector<uint32_t>& out)
+        : out_(out)
+      {
+      }
+
+      void save_string(const char* s, size_t len)
+      {
+        out_.push_back(len);
+        size_t pos = out_.size();
+        out_.resize(pos + (len + 3) / 4, 0);
+        memcpy(out_.data() + pos, s, len);
+      }
+
+      void save_string(const std::string& s)
+      {
+        save_string(s.data(), s.size());
+      }
+
+      // Number the BDD nodes of \a b in post-order.
+      unsigned save_node(const bdd& b)
+      {
+        if (b == bddfalse)
+          return 0;
+        if (b == bddtrue)
+          return 1;
+        auto it = node_num_.find(b.id());
+        if (it != node_num_.end())
+          return it->second;
+        unsigned low = save_node(bdd_low(b));
+        unsigned high = save_node(bdd_high(b));
+        int var = bdd_var(b);
+        if (SPOT_UNLIKELY((unsigned) var >= ap_of_var_.size()
+                          || ap_of_var_[var] == -1U))
+          throw std::runtime_error("print_binary(): edge label uses a "
+                                   "BDD variable that is not an atomic "
+                                   "proposition of the automaton");
+        nodes_.push_back(ap_of_var_[var]);
+        nodes_.push_back(low);
+        nodes_.push_back(high);
+        unsigned res = nodes_.size() / 3 + 1;
+        node_num_.emplace(b.id(), res);
+        return res;
+      }
+
+      void save(const const_twa_graph_ptr& g)
+      {
+        size_t start = out_.size();
+        out_.resize(start + header_words);
+        binary_header h;
+        memcpy(h.magic, binary_magic, sizeof(h.magic));
+        h.byte_order = binary_byte_order;
+
+        auto& aps = g->ap();
+        h.num_aps = aps.size();
+        auto d = g->get_dict();
+        ap_of_var_.assign(bdd_varnum(), -1U);
+        for (unsigned i = 0; i < h.num_aps; ++i)
+          {
+            save_string(aps[i].ap_name());
+            ap_of_var_[d->varnum(aps[i])] = i;
+          }
+
+        // Number the distinct labels first, so that the nodes can be
+        // output before the labels that refer to them.
+        std::unordered_map<int, unsigned> label_num;
+        std::vector<uint32_t> labels;
+        unsigned ns = g->num_states();
+        std::vector<uint32_t> edges;
+        edges.reserve(3 * g->num_edges());
+        std::vector<uint32_t> offsets;
+        offsets.reserve(ns + 1);
+        offsets.push_back(1);
+        unsigned init = ns ? g->get_init_state_number() : 0;
+        bool init_is_dst = false;
+        for (unsigned s = 0; s < ns; ++s)
+          {
+            for (auto& e: g->out(s))
+              {
+                auto p = label_num.emplace(e.cond.id(), labels.size());
+                if (p.second)
+                  labels.push_back(save_node(e.cond));
+                init_is_dst |= e.dst == init;
+                edges.push_back(e.dst);
+                edges.push_back(p.first->second);
+                edges.push_back(e.acc.id);
+              }
+            offsets.push_back(edges.size() / 3 + 1);
+          }
+        h.num_nodes = nodes_.size() / 3;
+        out_.insert(out_.end(), nodes_.begin(), nodes_.end());
+        h.num_labels = labels.size();
+        out_.insert(out_.end(), labels.begin(), labels.end());
+
+        auto& code = g->get_acceptance();
+        h.num_sets = g->num_sets();
+        h.acc_size = code.size();
+        {
+          size_t pos = out_.size();
+          out_.resize(pos + h.acc_size);
+          memcpy(out_.data() + pos, code.data(), 4 * h.acc_size);
+        }
+
+        if (ns == 0)
+          {
+            h.num_init = 0;
+          }
+        else
+          {
+            size_t pos = out_.size();
+            for (unsigned i: g->univ_dests(init))
+              out_.push_back(i);
+            h.num_init = out_.size() - pos;
+          }
+
+        h.num_states = ns;
+        out_.insert(out_.end(), offsets.begin(), offsets.end());
+        h.num_edges = edges.size() / 3;
+        out_.insert(out_.end(), edges.begin(), edges.end());
+        auto& dests = g->get_graph().dests_vector();
+        h.num_dests = dests.size();
+        // The loader recreates the group of a universal initial state
+        // at the end of the destination groups.  Do not save this
+        // group if it is already there, so that saving a loaded
+        // automaton gives back the same file.
+        if (h.num_init > 1 && !init_is_dst
+            && ~init + 1 + h.num_init == h.num_dests)
+          h.num_dests = ~init;
+        out_.insert(out_.end(), dests.begin(), dests.begin() + h.num_dests);
+
+        h.flags = 0;
+        if (auto n = g->get_named_prop<std::string>("automaton-name"))
+          {
+            h.flags |= has_name;
+            save_string(*n);
+          }
+        if (auto sn =
+            g->get_named_prop<std::vector<std::string>>("state-names"))
+          {
+            h.flags |= has_state_names;
+            for (unsigned s = 0; s < ns; ++s)
+              save_string(s < sn->size() ? (*sn)[s] : std::string());
+          }
+        else if (auto sp = g->get_named_prop<string_pool>("state-name-pool"))
+          {
+            h.flags |= has_state_names;
+            for (unsigned s = 0; s < ns; ++s)
+              if (s < sp->size())
+                save_string(sp->c_str(s), sp->length(s));
+              else
+                save_string(std::string());
+          }
+
+        memset(h.props, 0, sizeof(h.props));
+        for (unsigned i = 0; i < num_props; ++i)
+          h.props[i] = (g.get()->*prop_getters[i])().val();
+
+        h.size = 4 * (out_.size() - start);
+        memcpy(out_.data() + start, &h, sizeof(h));
+      }
+    };
+
+    [[noreturn]] void corrupted(const std::string& filename)
+    {
+      throw std::runtime_error(filename + ": corrupted binary automaton");
+    }
+  }
+
+  std::ostream&
+  print_binary(std::ostream& os, const const_twa_graph_ptr& g)
+  {
+    std::vector<uint32_t> out;
+    binary_writer(out).save(g);
+    os.write(reinterpret_cast<const char*>(out.data()), 4 * out.size());
+    return os;
+  }
+
+  binary_aut_reader::binary_aut_reader(const std::string& filename)
+    : filename_(filename)
+  {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("cannot open " + filename + ": "
+                               + strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+      {
+        size_ = st.st_size;
+        if (size_ > 0)
+          {
+            void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+              {
+                int err = errno;
+                close(fd);
+                throw std::runtime_error("cannot map " + filename + ": "
+                                         + strerror(err));
+              }
+#ifdef MADV_SEQUENTIAL
+            madvise(p, size_, MADV_SEQUENTIAL);
+#endif
+            data_ = static_cast<const char*>(p);
+            mapped_ = true;
+          }
+      }
+    else
+      {
+        // Pipes and other special files cannot be mapped.
+        std::string buf;
+        char tmp[65536];
+        ssize_t n;
+        while ((n = ::read(fd, tmp, sizeof(tmp))) > 0)
+          buf.append(tmp, n);
+        size_ = buf.size();
+        char* p = new char[size_ ? size_ : 1];
+        memcpy(p, buf.data(), size_);
+        data_ = p;
+      }
+    close(fd);
+  }
+
+  binary_aut_reader::~binary_aut_reader()
+  {
+    if (mapped_)
+      munmap(const_cast<char*>(data_), size_);
+    else
+      delete[] data_;
+  }
+
+  bool
+  binary_aut_reader::is_binary(const std::string& filename)
+  {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    char buf[sizeof(binary_magic)];
+    bool res = (::read(fd, buf, sizeof(buf)) == sizeof(buf)
+                && !memcmp(buf, binary_magic, sizeof(buf) - 1));
+    close(fd);
+    return res;
+  }
+
+  twa_graph_ptr
+  binary_aut_reader::read(const bdd_dict_ptr& dict)
+  {
+    if (pos_ >= size_)
+      return nullptr;
+    binary_header h;
+    if (size_ - pos_ < sizeof(h))
+      corrupted(filename_);
+    memcpy(&h, data_ + pos_, sizeof(h));
+    if (memcmp(h.magic, binary_magic, sizeof(h.magic) - 1))
+      corrupted(filename_);
+    if (h.magic[sizeof(h.magic) - 1] != binary_magic[sizeof(h.magic) - 1])
+      throw std::runtime_error(filename_ + ": unsupported version of "
+                               "the binary format");
+    if (h.byte_order != binary_byte_order)
+      throw std::runtime_error(filename_ + ": binary automaton was saved "
+                               "with a different byte order");
+    if (h.size < sizeof(h) || h.size % 4 || h.size > size_ - pos_)
+      corrupted(filename_);
+
+    const uint32_t* p =
+      reinterpret_cast<const uint32_t*>(data_ + pos_) + header_words;
+    const uint32_t* end =
+      reinterpret_cast<const uint32_t*>(data_ + pos_ + h.size);
+    pos_ += h.size;
+
+    auto need = [&](uint64_t words)
+      {
+        if (SPOT_UNLIKELY(words > (uint64_t)(end - p)))
+          corrupted(filename_);
+      };
+    auto load_string = [&]()
+      {
+        need(1);
+        uint32_t len = *p++;
+        need((len + 3ULL) / 4);
+        std::string s(reinterpret_cast<const char*>(p), len);
+        p += (len + 3ULL) / 4;
+        return s;
+      };
+
+    typedef acc_cond::mark_t::value_t mark_value;
+    if (SPOT_UNLIKELY(h.num_sets > 8 * sizeof(mark_value)))
+      corrupted(filename_);
+    mark_value all_sets =
+      h.num_sets ? -1U >> (8 * sizeof(mark_value) - h.num_sets) : 0U;
+
+    auto aut = make_twa_graph(dict);
+
+    // Each count of the header is checked against the size of the
+    // data before anything is allocated from it, so that a corrupted
+    // header cannot trigger a huge allocation.  Each name uses at
+    // least one word.
+    need(h.num_aps);
+    std::vector<int> ap_var;
+    ap_var.reserve(h.num_aps);
+    for (unsigned i = 0; i < h.num_aps; ++i)
+      ap_var.push_back(aut->register_ap(load_string()));
+
+    need(3ULL * h.num_nodes);
+    std::vector<bdd> nodes(h.num_nodes);
+    {
+      std::vector<int> tmp(p, p + 3ULL * h.num_nodes);
+      p += 3ULL * h.num_nodes;
+      // Validate the nodes here, as BuDDy's default error handler
+      // would abort.
+      for (unsigned i = 0; i < h.num_nodes; ++i)
+        {
+          if (SPOT_UNLIKELY((unsigned) tmp[3 * i] >= h.num_aps
+                            || (unsigned) tmp[3 * i + 1] >= i + 2
+                            || (unsigned) tmp[3 * i + 2] >= i + 2))
+            corrupted(filename_);
+          tmp[3 * i] = ap_var[tmp[3 * i]];
+        }
+      int err = bdd_loadarray(tmp.data(), h.num_nodes, nodes.data());
+      if (err)
+        throw std::runtime_error(filename_ + ": failed to load BDDs: "
+                                 + bdd_errstring(err));
+    }
+
+    need(h.num_labels);
+    std::vector<bdd> labels;
+    labels.reserve(h.num_labels);
+    for (unsigned i = 0; i < h.num_labels; ++i)
+      {
+        uint32_t r = *p++;
+        if (r == 0)
+          labels.emplace_back(bddfalse);
+        else if (r == 1)
+          labels.emplace_back(bddtrue);
+        else if (SPOT_LIKELY(r - 2 < h.num_nodes))
+          labels.emplace_back(nodes[r - 2]);
+        else
+          corrupted(filename_);
+      }
+    nodes.clear();
+
+    {
+      need(h.acc_size);
+      acc_cond::acc_code code;
+      code.resize(h.acc_size);
+      memcpy(code.data(), p, 4ULL * h.acc_size);
+      p += h.acc_size;
+      // The code is stored in postfix order: each operator follows
+      // its operands, and gives the number of words they use.  Check
+      // that the last operator spans the whole code, and that each
+      // operator fits in the operator it is an operand of.  lows
+      // holds the first word of each And/Or being checked.
+      if (h.acc_size > 0)
+        {
+          if (SPOT_UNLIKELY(code.back().sub.size + 1U != h.acc_size))
+            corrupted(filename_);
+          std::vector<unsigned> lows = { 0 };
+          unsigned i = h.acc_size;
+          while (i > 0)
+            {
+              auto& w = code[i - 1];
+              if (SPOT_UNLIKELY(w.sub.size + 1U > i - lows.back()))
+                corrupted(filename_);
+              unsigned start = i - 1 - w.sub.size;
+              switch (w.sub.op)
+                {
+                case acc_cond::acc_op::Inf:
+                case acc_cond::acc_op::Fin:
+                case acc_cond::acc_op::InfNeg:
+                case acc_cond::acc_op::FinNeg:
+                  if (SPOT_UNLIKELY(w.sub.size != 1
+                                    || code[start].mark.id & ~all_sets))
+                    corrupted(filename_);
+                  i = start;
+                  break;
+                case acc_cond::acc_op::And:
+                case acc_cond::acc_op::Or:
+                  lows.push_back(start);
+                  --i;
+                  break;
+                default:
+                  corrupted(filename_);
+                }
+              while (lows.size() > 1 && i == lows.back())
+                lows.pop_back();
+            }
+        }
+      aut->set_acceptance(h.num_sets, code);
+    }
+
+    need(h.num_init);
+    const uint32_t* init = p;
+    p += h.num_init;
+
+    unsigned ns = h.num_states;
+    need(ns + 1ULL);
+    const uint32_t* offsets = p;
+    p += ns + 1;
+    need(3ULL * h.num_edges);
+    const uint32_t* edges = p;
+    p += 3ULL * h.num_edges;
+    need(h.num_dests);
+    if (offsets[0] != 1 || offsets[ns] != h.num_edges + 1)
+      corrupted(filename_);
+
+    // The destination groups of universal edges are stored as a
+    // size followed by that many states.  Edges may only point to
+    // the start of a group.
+    std::vector<bool> group_start(h.num_dests, false);
+    for (unsigned i = 0; i < h.num_dests;)
+      {
+        unsigned sz = p[i];
+        if (SPOT_UNLIKELY(sz == 0 || sz >= h.num_dests - i))
+          corrupted(filename_);
+        group_start[i] = true;
+        for (unsigned j = i + 1; j <= i + sz; ++j)
+          if (SPOT_UNLIKELY(p[j] >= ns))
+            corrupted(filename_);
+        i += sz + 1;
+      }
+
+    auto& g = aut->get_graph();
+    g.new_states(ns);
+    auto& ev = g.edge_vector();
+    ev.reserve(h.num_edges + 1);
+    for (unsigned s = 0; s < ns; ++s)
+      {
+        unsigned b = offsets[s];
+        unsigned e = offsets[s + 1];
+        if (b == e)
+          continue;
+        if (SPOT_UNLIKELY(e < b || e > h.num_edges + 1))
+          corrupted(filename_);
+        auto& st = g.state_storage(s);
+        st.succ = b;
+        st.succ_tail = e - 1;
+        for (unsigned i = b; i < e; ++i)
+          {
+            const uint32_t* t = edges + 3 * (i - 1);
+            unsigned dst = t[0];
+            if (SPOT_UNLIKELY(aut->is_univ_dest(dst)
+                              ? ~dst >= h.num_dests || !group_start[~dst]
+                              : dst >= ns)
+                || SPOT_UNLIKELY(t[1] >= h.num_labels)
+                || SPOT_UNLIKELY(t[2] & ~all_sets))
+              corrupted(filename_);
+            ev.emplace_back(dst, i + 1 < e ? i + 1 : 0, s,
+                            labels[t[1]], acc_cond::mark_t(t[2]));
+          }
+      }
+    g.dests_vector().assign(p, p + h.num_dests);
+    p += h.num_dests;
+    // The edges are already grouped by source, so this only
+    // builds the offsets of the frozen layout.
+    aut->freeze();
+
+    for (unsigned i = 0; i < h.num_init; ++i)
+      if (SPOT_UNLIKELY(init[i] >= ns))
+        corrupted(filename_);
+    if (h.num_init == 1)
+      aut->set_init_state(init[0]);
+    else if (h.num_init > 1)
+      aut->set_univ_init_state(init, init + h.num_init);
+
+    if (h.flags & has_name)
+      aut->set_named_prop("automaton-name", new std::string(load_string()));
+    if (h.flags & has_state_names)
+      {
+        auto sn = new std::vector<std::string>;
+        aut->set_named_prop("state-names", sn);
+        sn->reserve(ns);
+        for (unsigned s = 0; s < ns; ++s)
+          sn->emplace_back(load_string());
+      }
+
+    for (unsigned i = 0; i < num_props; ++i)
+      (aut.get()->*prop_setters[i])(trival(h.props[i]));
+    return aut;
+  }
+}
@@ -0,0 +1,89 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <spot/misc/common.hh>
+#include <spot/twa/fwd.hh>
+#include <spot/twa/bdddict.hh>
+
+namespace spot
+{
+  /// \ingroup twa_io
+  /// \brief Save an automaton in Spot's binary format.
+  ///
+  /// This format is meant to save and reload large automata quickly,
+  /// on the same machine: it stores the arrays of the graph, the
+  /// acceptance condition, and all edge labels as a single pool of
+  /// shared BDD nodes, in the byte order of the host.  Several
+  /// automata may be written one after the other in the same
+  /// stream.  Edges are renumbered so that the outgoing edges of
+  /// each state are contiguous.  The only named properties saved
+  /// are "automaton-name" and "state-names" (or "state-name-pool",
+  /// which is reloaded as "state-names").
+  ///
+  /// \param os The output stream to print on.  It should be opened
+  /// in binary mode.
+  /// \param g The automaton to output.
+  SPOT_API std::ostream&
+  print_binary(std::ostream& os, const const_twa_graph_ptr& g);
+
+  /// \ingroup twa_io
+  /// \brief Read automata saved by print_binary().
+  ///
+  /// Regular files are mapped into memory, so loading an automaton
+  /// amounts to copying its arrays into a twa_graph, and rebuilding
+  /// the BDD nodes of its labels.  Other files (e.g., pipes) are
+  /// first read into memory.  The automata returned are frozen (see
+  /// twa_graph::freeze()).
+  class SPOT_API binary_aut_reader final
+  {
+  public:
+    /// \brief Open \a filename.
+    ///
+    /// \throw std::runtime_error if the file cannot be read.
+    binary_aut_reader(const std::string& filename);
+    ~binary_aut_reader();
+
+    binary_aut_reader(const binary_aut_reader&) = delete;
+    binary_aut_reader& operator=(const binary_aut_reader&) = delete;
+
+    /// \brief Read the next automaton.
+    ///
+    /// \return the automaton, or nullptr at the end of the file.
+    /// \throw std::runtime_error if the file is corrupted, or has
+    /// been written on a machine with a different byte order.
+    twa_graph_ptr read(const bdd_dict_ptr& dict);
+
+    /// \brief Whether \a filename looks like a file written by
+    /// print_binary().
+    ///
+    /// This only reads the first bytes of the file.
+    static bool is_binary(const std::string& filename);
+
+  private:
+    std::string filename_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+    bool mapped_ = false;
+  };
+}
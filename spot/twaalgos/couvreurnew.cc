@@ -94,7 +94,7 @@ namespace spot
       using state_t = const state*;
       using iterator_t = twa_succ_iterator*;
       template<class val>
-      using state_map = spot::state_map<val>;
+      using state_map = spot::state_store<val>;
 
       template<class val>
       static
@@ -102,7 +102,8 @@ namespace spot
       h_emplace(state_map<val>& h, state_t s, val i)
       {
         auto p = h.emplace(s, i);
-        return std::make_pair(*p.first, p.second);
+        return std::make_pair(std::make_pair(p.first->first,
+                                             p.first->second), p.second);
       }
 
       static
@@ -325,9 +326,7 @@ namespace spot
       typename std::enable_if<!U>::type
       uninit()
       {
-        auto i = h.begin();
-        while (i != h.end())
-          i++->first->destroy();
+        h.destroy_states();
       }
     };
 
@@ -27,6 +27,7 @@
 
 
 #include <spot/misc/bddlt.hh>
+#include <spot/misc/strpool.hh>
 #include <spot/twaalgos/sccinfo.hh>
 #include <spot/twaalgos/determinize.hh>
 #include <spot/twaalgos/degen.hh>
@@ -539,13 +540,18 @@ namespace spot
       return os.str();
     }
 
-    std::vector<std::string>*
+    string_pool*
     print_debug(const const_twa_graph_ptr& aut,
                 const power_set& states)
     {
-      auto res = new std::vector<std::string>(states.size());
+      // The pool is filled in the order of state numbers.
+      std::vector<const safra_state*> by_num(states.size());
       for (const auto& p: states)
-        (*res)[p.second] = nodes_to_string(aut, p.first);
+        by_num[p.second] = &p.first;
+      auto res = new string_pool;
+      res->reserve(by_num.size());
+      for (auto* s: by_num)
+        res->push_back(nodes_to_string(aut, *s));
       return res;
     }
 
@@ -975,7 +981,7 @@ namespace spot
     res->prop_state_acc(false);
 
     if (pretty_print)
-      res->set_named_prop("state-names", print_debug(aut, seen));
+      res->set_named_prop("state-name-pool", print_debug(aut, seen));
     return res;
   }
 }
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2015, 2016 Laboratoire de Recherche et Développement
+// Copyright (C) 2015, 2016, 2018 Laboratoire de Recherche et Développement
 // de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -56,7 +56,9 @@ namespace spot
   ///                     acceptance already, otherwise the input
   ///                     automaton will be degeneralized and the
   ///                     names will refer to the states in the
-  ///                     degeneralized automaton).
+  ///                     degeneralized automaton).  The names
+  ///                     are stored in the "state-name-pool"
+  ///                     named property.
   ///
   /// \param use_scc whether to simplify the construction based on
   ///                the SCCs in the input automaton.
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2012, 2014-2017 Laboratoire de Recherche
+// Copyright (C) 2011, 2012, 2014-2018 Laboratoire de Recherche
 // et Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -29,6 +29,7 @@
 #include <spot/twa/bddprint.hh>
 #include <spot/twaalgos/reachiter.hh>
 #include <spot/misc/escape.hh>
+#include <spot/misc/strpool.hh>
 #include <spot/twa/twagraph.hh>
 #include <spot/twa/formula2bdd.hh>
 #include <spot/twaalgos/sccinfo.hh>
@@ -72,6 +73,7 @@ namespace spot
     {
       // Keep all 0/false-initialized values together.
       std::vector<std::string>* sn_ = nullptr;
+      string_pool* sp_ = nullptr;
       std::map<unsigned, unsigned>* highlight_edges_ = nullptr;
       std::map<unsigned, unsigned>* highlight_states_ = nullptr;
       std::vector<std::pair<unsigned, unsigned>>* sprod_ = nullptr;
@@ -581,6 +583,8 @@ namespace spot
         os_ << "  " << s << " [" << label_pre_;
         if (sn_ && s < sn_->size() && !(*sn_)[s].empty())
           escape_for_output(os_, (*sn_)[s]);
+        else if (sp_ && s < sp_->size() && sp_->length(s))
+          escape_for_output(os_, sp_->str(s));
         else if (sprod_)
           os_ << (*sprod_)[s].first << ',' << (*sprod_)[s].second;
         else
@@ -709,8 +713,10 @@ namespace spot
         if (opt_want_state_names_)
           {
             sn_ = aut->get_named_prop<std::vector<std::string>>("state-names");
-            // We have no names.  Do we have product sources?
             if (!sn_)
+              sp_ = aut->get_named_prop<string_pool>("state-name-pool");
+            // We have no names.  Do we have product sources?
+            if (!sn_ && !sp_)
               {
                 sprod_ = aut->get_named_prop
                   <std::vector<std::pair<unsigned, unsigned>>>
@@ -757,7 +763,7 @@ namespace spot
                      && (aut_->acc().is_buchi() || aut_->acc().is_co_buchi()));
         if (opt_shape_ == ShapeAuto)
           {
-            if (sn_ || sprod_ || aut->num_states() > 100
+            if (sn_ || sp_ || sprod_ || aut->num_states() > 100
                 || opt_state_labels_ || orig_)
               {
                 opt_shape_ = ShapeEllipse;
@@ -767,6 +773,15 @@ namespace spot
                                        [](const std::string& s)
                                        { return s.size() <= 2; }))
                   opt_shape_ = ShapeCircle;
+                if (!opt_state_labels_ && !orig_ && sp_)
+                  {
+                    unsigned n = sp_->size();
+                    unsigned s = 0;
+                    while (s < n && sp_->length(s) <= 2)
+                      ++s;
+                    if (s == n)
+                      opt_shape_ = ShapeCircle;
+                  }
               }
             else
               {
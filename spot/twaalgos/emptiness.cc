@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2009, 2011-2017 Laboratoire de Recherche et
+// Copyright (C) 2009, 2011-2018 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 // Copyright (C) 2004, 2005 Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -30,6 +30,7 @@
 #include <spot/twaalgos/magic.hh>
 #include <spot/misc/hash.hh>
 #include <spot/twaalgos/se05.hh>
+#include <spot/twaalgos/swarm.hh>
 #include <spot/twaalgos/tau03.hh>
 #include <spot/twaalgos/tau03opt.hh>
 #include <spot/twa/bddprint.hh>
@@ -161,7 +162,10 @@ namespace spot
   emptiness_check_ptr
   emptiness_check_instantiator::instantiate(const const_twa_ptr& a) const
   {
-    return static_cast<ec_algo*>(info_)->construct(a, o_);
+    auto construct = static_cast<ec_algo*>(info_)->construct;
+    if (o_.get("swarm"))
+      return swarm_check(a, construct, o_);
+    return construct(a, o_);
   }
 
   emptiness_check_instantiator_ptr
@@ -1,6 +1,6 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2013, 2014, 2015, 2016, 2017 Laboratoire de
-// Recherche et Developpement de l'Epita (LRDE).
+// Copyright (C) 2011, 2013-2018 Laboratoire de Recherche et
+// Developpement de l'Epita (LRDE).
 // Copyright (C) 2004, 2005 Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
 // et Marie Curie.
@@ -358,6 +358,17 @@ namespace spot
   ///   Tau03_opt(condstack !weights)
   ///   Tau03_opt(condstack !redweights)
   ///   \endcode
+  ///
+  /// Any of these algorithms can be run as a swarm (see
+  /// `spot::swarm_check()`) by setting option `swarm` to the number
+  /// of independent searches to start.  Options `seed` and
+  /// `swarm_mem` are then also honored.
+  ///
+  ///   Examples:
+  ///   \code
+  ///   SE05(swarm=8)
+  ///   CVWY90(bsh=4M swarm=8 swarm_mem=512)
+  ///   \endcode
   SPOT_API emptiness_check_instantiator_ptr
   make_emptiness_check_instantiator(const char* name, const char** err);
 
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2015-2017 Laboratoire de Recherche et Développement de
+// Copyright (C) 2015-2018 Laboratoire de Recherche et Développement de
 // l'Epita (LRDE).
 // Copyright (C) 2004, 2005 Laboratoire d'Informatique de Paris 6
 // (LIP6), département Systèmes Répartis Coopératifs (SRC), Université
@@ -85,6 +85,12 @@ namespace spot
       ++states_;
     }
 
+    void
+    set_transitions(unsigned n)
+    {
+      transitions_ = n;
+    }
+
     void
     inc_transitions()
     {
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2008, 2011, 2014, 2015, 2016 Laboratoire de Recherche
+// Copyright (C) 2008, 2011, 2014-2016, 2018 Laboratoire de Recherche
 // et Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004, 2005, 2006 Laboratoire d'Informatique de
 // Paris 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
@@ -37,7 +37,18 @@ namespace spot
 {
   namespace
   {
-    typedef std::pair<const spot::state*, twa_succ_iterator*> pair_state_iter;
+    // An item of the DFS stack: a state, and the iterator over its
+    // successors.  If this iterator supports bulk access, it is
+    // released immediately, ITER is null, and the successors are
+    // read from a buffer shared by all items, between POS and END.
+    struct dfs_item
+    {
+      const spot::state* s;
+      twa_succ_iterator* iter;
+      unsigned begin;
+      unsigned pos;
+      unsigned end;
+    };
   }
 
   couvreur99_check::couvreur99_check(const const_twa_ptr& a, option_map o)
@@ -149,12 +160,32 @@ namespace spot
     // * num, the number of visited nodes.  Used to set the order of each
     //   visited node,
     int num = 1;
-    // * todo, the depth-first search stack.  This holds pairs of the
+    // * todo, the depth-first search stack.  This holds items of the
     //   form (STATE, ITERATOR) where ITERATOR is a twa_succ_iterator
     //   over the successors of STATE.  In our use, ITERATOR should
     //   always be freed when TODO is popped, but STATE should not because
     //   it is also used as a key in H.
-    std::stack<pair_state_iter> todo;
+    std::stack<dfs_item> todo;
+    // * succs, the successors of the items of TODO whose iterator
+    //   supports bulk access.  This is used as a stack too.
+    std::vector<twa_succ_entry> succs;
+
+    auto push_todo = [&](const state* s)
+      {
+        twa_succ_iterator* iter = ecs_->aut->succ_iter(s);
+        unsigned begin = succs.size();
+        if (iter->fill_succ(succs))
+          {
+            ecs_->aut->release_iter(iter);
+            iter = nullptr;
+          }
+        else
+          {
+            iter->first();
+          }
+        todo.push({s, iter, begin, begin, unsigned(succs.size())});
+        inc_depth();
+      };
 
     // Setup depth-first search from the initial state.
     {
@@ -162,26 +193,25 @@ namespace spot
       ecs_->h[init] = 1;
       ecs_->root.push(1);
       arc.push(0U);
-      twa_succ_iterator* iter = ecs_->aut->succ_iter(init);
-      iter->first();
-      todo.emplace(init, iter);
-      inc_depth();
+      push_todo(init);
     }
 
     while (!todo.empty())
       {
         assert(ecs_->root.size() == arc.size());
 
-        // We are looking at the next successor in SUCC.
-        twa_succ_iterator* succ = todo.top().second;
+        // We are looking at the next successor of the top item.
+        dfs_item& top = todo.top();
+        twa_succ_iterator* succ = top.iter;
 
         // If there is no more successor, backtrack.
-        if (succ->done())
+        if (succ ? succ->done() : top.pos == top.end)
           {
             // We have explored all successors of state CURR.
-            const state* curr = todo.top().first;
+            const state* curr = top.s;
 
             // Backtrack TODO.
+            succs.resize(top.begin);
             todo.pop();
             dec_depth();
 
@@ -206,7 +236,8 @@ namespace spot
                 remove_component(curr);
                 ecs_->root.pop();
               }
-            ecs_->aut->release_iter(succ);
+            if (succ)
+              ecs_->aut->release_iter(succ);
             // Do not destroy CURR: it is a key in H.
             continue;
           }
@@ -215,12 +246,23 @@ namespace spot
         inc_transitions();
         // Fetch the values (destination state, acceptance conditions
         // of the arc) we are interested in...
-        const state* dest = succ->dst();
-        acc_cond::mark_t acc = succ->acc();
-        // ... and point the iterator to the next successor, for
-        // the next iteration.
-        succ->next();
-        // We do not need SUCC from now on.
+        const state* dest;
+        acc_cond::mark_t acc;
+        if (succ)
+          {
+            dest = succ->dst();
+            acc = succ->acc();
+            // ... and point the iterator to the next successor, for
+            // the next iteration.
+            succ->next();
+          }
+        else
+          {
+            dest = succs[top.pos].dst;
+            acc = succs[top.pos].acc;
+            ++top.pos;
+          }
+        // We do not need SUCC and TOP from now on.
 
         // Are we going to a new state?
         auto p = ecs_->h.emplace(dest, num + 1);
@@ -230,10 +272,7 @@ namespace spot
             // successors for later processing.
             ecs_->root.push(++num);
             arc.push(acc);
-            twa_succ_iterator* iter = ecs_->aut->succ_iter(dest);
-            iter->first();
-            todo.emplace(dest, iter);
-            inc_depth();
+            push_todo(dest);
             continue;
           }
         dest->destroy();
@@ -277,10 +316,15 @@ namespace spot
         if (ecs_->aut->acc().accepting(ecs_->root.top().condition))
           {
             // We have found an accepting SCC.
-            // Release all iterators in TODO.
+            // Release all iterators and unprocessed successors in TODO.
             while (!todo.empty())
               {
-                ecs_->aut->release_iter(todo.top().second);
+                dfs_item& t = todo.top();
+                if (t.iter)
+                  ecs_->aut->release_iter(t.iter);
+                else
+                  for (unsigned i = t.pos; i < t.end; ++i)
+                    succs[i].dst->destroy();
                 todo.pop();
                 dec_depth();
               }
@@ -317,13 +361,30 @@ namespace spot
                                              couvreur99_check_shy* shy)
         : s(s), n(n)
   {
-    for (auto iter: shy->ecs_->aut->succ(s))
+    twa_succ_iterator* iter = shy->ecs_->aut->succ_iter(s);
+    std::vector<twa_succ_entry>& succs = shy->succs_;
+    succs.clear();
+    if (iter->fill_succ(succs))
       {
-        q.emplace_back(iter->acc(),
-                       iter->dst());
-        shy->inc_depth();
-        shy->inc_transitions();
+        for (auto& e: succs)
+          {
+            q.emplace_back(e.acc, e.dst);
+            shy->inc_depth();
+            shy->inc_transitions();
+          }
+      }
+    else if (iter->first())
+      {
+        do
+          {
+            q.emplace_back(iter->acc(),
+                           iter->dst());
+            shy->inc_depth();
+            shy->inc_transitions();
+          }
+        while (iter->next());
       }
+    shy->ecs_->aut->release_iter(iter);
   }
 
   couvreur99_check_shy::couvreur99_check_shy(const const_twa_ptr& a,
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2008, 2013, 2014, 2015, 2016 Laboratoire de Recherche
+// Copyright (C) 2008, 2013-2016, 2018 Laboratoire de Recherche
 // et Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004, 2005, 2006 Laboratoire d'Informatique de
 // Paris 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
@@ -228,6 +228,9 @@ namespace spot
     typedef std::list<todo_item> todo_list;
     todo_list todo;
 
+    // Buffer used by todo_item to gather successors in bulk.
+    std::vector<twa_succ_entry> succs_;
+
     void clear_todo();
 
     /// Dump the queue for debugging.
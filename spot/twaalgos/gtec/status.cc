@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014, 2016 Laboratoire de Recherche et Développement
+// Copyright (C) 2014, 2016, 2018 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 // Copyright (C) 2004  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -32,14 +32,7 @@ namespace spot
 
   couvreur99_check_status::~couvreur99_check_status()
   {
-    auto i = h.begin();
-    while (i != h.end())
-      {
-        // Advance the iterator before deleting the key.
-        const state* s = i->first;
-        ++i;
-        s->destroy();
-      }
+    h.destroy_states();
   }
 
   void
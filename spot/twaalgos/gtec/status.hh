@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013, 2014, 2016 Laboratoire de Recherche et
+// Copyright (C) 2013, 2014, 2016, 2018 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 // Copyright (C) 2004  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -43,7 +43,7 @@ namespace spot
     const_twa_ptr aut;
     scc_stack root;
 
-    state_map<int> h;
+    state_store<int> h;
 
     const state* cycle_seed;
 
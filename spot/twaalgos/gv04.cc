@@ -55,7 +55,7 @@ namespace spot
     struct gv04: public emptiness_check, public ec_statistics
     {
       // Map of visited states.
-      state_map<size_t> h;
+      state_store<size_t> h;
 
       // Stack of visited states on the path.
       std::vector<stack_entry> stack;
@@ -78,14 +78,7 @@ namespace spot
       {
         for (auto i: stack)
           a_->release_iter(i.lasttr);
-        auto s = h.begin();
-        while (s != h.end())
-          {
-            // Advance the iterator before deleting the "key" pointer.
-            const state* ptr = s->first;
-            ++s;
-            ptr->destroy();
-          }
+        h.destroy_states();
       }
 
       virtual emptiness_check_result_ptr
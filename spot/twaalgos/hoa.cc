@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2012, 2014, 2015, 2016, 2017 Laboratoire de Recherche et
+// Copyright (C) 2011, 2012, 2014-2018 Laboratoire de Recherche et
 // Developpement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -23,6 +23,7 @@
 #include <ostream>
 #include <sstream>
 #include <cstring>
+#include <deque>
 #include <map>
 #include <spot/twa/twa.hh>
 #include <spot/twa/twagraph.hh>
@@ -31,6 +32,7 @@
 #include <spot/misc/escape.hh>
 #include <spot/misc/bddlt.hh>
 #include <spot/misc/minato.hh>
+#include <spot/misc/strpool.hh>
 #include <spot/twa/formula2bdd.hh>
 #include <spot/tl/formula.hh>
 #include <spot/kripke/fairkripke.hh>
@@ -52,6 +54,10 @@ namespace spot
       bool is_complete;
       bool is_universal;
       bool is_colored;
+      // Whether is_universal, is_complete, and is_colored have been
+      // computed by looking at all edges, or have simply been taken
+      // from the properties of the automaton (on-the-fly output).
+      bool exact = true;
       bool use_implicit_labels;
       bool use_state_labels = true;
       bdd all_ap;
@@ -70,6 +76,23 @@ namespace spot
         number_all_ap(aut);
       }
 
+      // For automata that are printed on-the-fly, we cannot look at
+      // the edges before the header is output, so we have to trust
+      // the properties of the automaton.  Labels are then computed
+      // lazily by label().
+      metadata(const const_twa_ptr& aut, bool implicit,
+               bool state_labels)
+        : exact(false)
+      {
+        is_universal = aut->prop_universal().is_true();
+        is_complete = aut->prop_complete().is_true();
+        has_state_acc = aut->prop_state_acc().is_true();
+        is_colored = false;
+        use_implicit_labels = implicit && is_universal && is_complete;
+        use_state_labels &= state_labels;
+        number_all_ap(aut);
+      }
+
       std::ostream&
       emit_acc(std::ostream& os, acc_cond::mark_t b)
       {
@@ -178,7 +201,7 @@ namespace spot
                                    " prop_state_acc()==true");
       }
 
-      void number_all_ap(const const_twa_graph_ptr& aut)
+      void number_all_ap(const const_twa_ptr& aut)
       {
         // Make sure that the automaton uses only atomic propositions
         // that have been registered via twa::register_ap() or some
@@ -207,50 +230,60 @@ namespace spot
           return;
 
         for (auto& i: sup)
-          {
-            bdd cond = i.first;
-            if (cond == bddtrue)
-              {
-                i.second = "t";
-                continue;
-              }
-            if (cond == bddfalse)
-              {
-                i.second = "f";
-                continue;
-              }
-            std::ostringstream s;
-            bool notfirstor = false;
+          i.second = format_label(i.first);
+      }
 
-            minato_isop isop(cond);
-            bdd cube;
-            while ((cube = isop.next()) != bddfalse)
+      std::string format_label(bdd cond)
+      {
+        if (cond == bddtrue)
+          return "t";
+        if (cond == bddfalse)
+          return "f";
+        std::ostringstream s;
+        bool notfirstor = false;
+
+        minato_isop isop(cond);
+        bdd cube;
+        while ((cube = isop.next()) != bddfalse)
+          {
+            if (notfirstor)
+              s << " | ";
+            bool notfirstand = false;
+            while (cube != bddtrue)
               {
-                if (notfirstor)
-                  s << " | ";
-                bool notfirstand = false;
-                while (cube != bddtrue)
+                if (notfirstand)
+                  s << '&';
+                else
+                  notfirstand = true;
+                bdd h = bdd_high(cube);
+                if (h == bddfalse)
                   {
-                    if (notfirstand)
-                      s << '&';
-                    else
-                      notfirstand = true;
-                    bdd h = bdd_high(cube);
-                    if (h == bddfalse)
-                      {
-                        s << '!' << ap[bdd_var(cube)];
-                        cube = bdd_low(cube);
-                      }
-                    else
-                      {
-                        s << ap[bdd_var(cube)];
-                        cube = h;
-                      }
+                    s << '!' << ap[bdd_var(cube)];
+                    cube = bdd_low(cube);
+                  }
+                else
+                  {
+                    s << ap[bdd_var(cube)];
+                    cube = h;
                   }
-                notfirstor = true;
               }
-            i.second = s.str();
+            notfirstor = true;
           }
+        return s.str();
+      }
+
+      // Label of an edge, for on-the-fly output.
+      const std::string& label(bdd cond)
+      {
+        auto p = sup.emplace(cond, std::string());
+        if (p.second)
+          {
+            if (bdd_exist(bdd_support(cond), all_ap) != bddtrue)
+              throw std::runtime_error("print_hoa(): automaton uses "
+                                       "unregistered atomic propositions");
+            p.first->second = format_label(cond);
+          }
+        return p.first->second;
       }
     };
 
@@ -266,98 +299,83 @@ namespace spot
       Hoa_Acceptance_Mixed    /// mix state-based and transition-based
     };
 
-  static std::ostream&
-  print_hoa(std::ostream& os,
-                const const_twa_graph_ptr& aut,
-                const char* opt)
+  namespace
   {
-    bool newline = true;
-    hoa_acceptance acceptance = Hoa_Acceptance_States;
-    bool implicit_labels = false;
-    bool verbose = false;
-    bool state_labels = false;
-    bool v1_1 = false;
-
-    if (opt)
-      while (*opt)
-        {
-          switch (char c = *opt++)
+    struct hoa_options final
+    {
+      bool newline = true;
+      hoa_acceptance acceptance = Hoa_Acceptance_States;
+      bool implicit_labels = false;
+      bool verbose = false;
+      bool state_labels = false;
+      bool v1_1 = false;
+      bool on_the_fly = false;
+
+      hoa_options(const char* opt)
+      {
+        if (opt)
+          while (*opt)
             {
-            case '1':
-              if (opt[0] == '.' && opt[1] == '1')
-                {
-                  v1_1 = true;
-                  opt += 2;
-                }
-              else if (opt[0] == '.' && opt[1] == '0')
-                {
-                  v1_1 = false;
-                  opt += 2;
-                }
-              else
+              switch (char c = *opt++)
                 {
-                  v1_1 = false;
+                case '1':
+                  if (opt[0] == '.' && opt[1] == '1')
+                    {
+                      v1_1 = true;
+                      opt += 2;
+                    }
+                  else if (opt[0] == '.' && opt[1] == '0')
+                    {
+                      v1_1 = false;
+                      opt += 2;
+                    }
+                  else
+                    {
+                      v1_1 = false;
+                    }
+                  break;
+                case 'i':
+                  implicit_labels = true;
+                  break;
+                case 'k':
+                  state_labels = true;
+                  break;
+                case 'l':
+                  newline = false;
+                  break;
+                case 'm':
+                  acceptance = Hoa_Acceptance_Mixed;
+                  break;
+                case 'o':
+                  on_the_fly = true;
+                  break;
+                case 's':
+                  acceptance = Hoa_Acceptance_States;
+                  break;
+                case 't':
+                  acceptance = Hoa_Acceptance_Transitions;
+                  break;
+                case 'v':
+                  verbose = true;
+                  break;
+                default:
+                  throw std::runtime_error
+                    (std::string("unknown option for print_hoa(): ") + c);
                 }
-              break;
-            case 'i':
-              implicit_labels = true;
-              break;
-            case 'k':
-              state_labels = true;
-              break;
-            case 'l':
-              newline = false;
-              break;
-            case 'm':
-              acceptance = Hoa_Acceptance_Mixed;
-              break;
-            case 's':
-              acceptance = Hoa_Acceptance_States;
-              break;
-            case 't':
-              acceptance = Hoa_Acceptance_Transitions;
-              break;
-            case 'v':
-              verbose = true;
-              break;
-            default:
-              throw std::runtime_error
-                (std::string("unknown option for print_hoa(): ") + c);
             }
-        }
-
-    metadata md(aut, implicit_labels, state_labels);
-
-    if (acceptance == Hoa_Acceptance_States && !md.has_state_acc)
-      acceptance = Hoa_Acceptance_Transitions;
-
-    auto print_dst = [&os, &aut](unsigned dst)
-      {
-        bool notfirst = false;
-        for (unsigned d: aut->univ_dests(dst))
-          {
-            if (notfirst)
-              os << '&';
-            else
-              notfirst = true;
-            os << d;
-          }
-      };
-
-    unsigned num_states = aut->num_states();
-    unsigned init = aut->get_init_state_number();
+      }
+    };
+  }
 
-    const char nl = newline ? '\n' : ' ';
-    os << (v1_1 ? "HOA: v1.1" : "HOA: v1") << nl;
-    auto n = aut->get_named_prop<std::string>("automaton-name");
-    if (n)
-      escape_str(os << "name: \"", *n) << '"' << nl;
+  // Output the "AP:", "acc-name:", "Acceptance:", and "properties:"
+  // lines of the header.
+  static void
+  print_hoa_header(std::ostream& os, const const_twa_ptr& aut,
+                   metadata& md, const hoa_options& o, bool existential)
+  {
+    const char nl = o.newline ? '\n' : ' ';
     unsigned nap = md.vap.size();
-    os << "States: " << num_states << nl
-       << "Start: ";
-    print_dst(init);
-    os << nl
-       << "AP: " << nap;
+    os << "AP: " << nap;
     auto d = aut->get_dict();
     for (auto& i: md.vap)
       escape_str(os << " \"", d->bdd_map[i].f.ap_name()) << '"';
@@ -443,7 +461,7 @@ namespace spot
     unsigned prop_len = 60;
     auto prop = [&](const char* str)
       {
-        if (newline)
+        if (o.newline)
           {
             auto l = strlen(str);
             if (prop_len < l)
@@ -455,30 +473,28 @@ namespace spot
           }
         os << str;
       };
-    implicit_labels = md.use_implicit_labels;
-    state_labels = md.use_state_labels;
-    if (implicit_labels)
+    if (md.use_implicit_labels)
       prop(" implicit-labels");
-    else if (state_labels)
+    else if (md.use_state_labels)
       prop(" state-labels explicit-labels");
     else
       prop(" trans-labels explicit-labels");
-    if (acceptance == Hoa_Acceptance_States)
+    if (o.acceptance == Hoa_Acceptance_States)
       prop(" state-acc");
-    else if (acceptance == Hoa_Acceptance_Transitions)
+    else if (o.acceptance == Hoa_Acceptance_Transitions)
       prop(" trans-acc");
     if (md.is_colored)
       prop(" colored");
-    else if (verbose && v1_1)
+    else if (o.verbose && o.v1_1 && md.exact)
       prop(" !colored");
     if (md.is_complete)
       prop(" complete");
-    else if (v1_1)
+    else if (o.v1_1 && (md.exact || aut->prop_complete().is_false()))
       prop(" !complete");
     // The definition of "deterministic" was changed between HOA v1
     // (were it meant "universal") and HOA v1.1 were it means
     // ("universal" and "existential").
-    if (!v1_1)
+    if (!o.v1_1)
       {
         if (md.is_universal)
           prop(" deterministic");
@@ -486,13 +502,13 @@ namespace spot
         // property.  The "univ-branch" property seems more important to
         // announce that the automaton might not be parsable by tools that
         // do not support alternating automata.
-        if (!aut->is_existential())
+        if (!existential)
           {
             prop(" univ-branch");
           }
-        else if (verbose)
+        else if (o.verbose)
           {
-            if (v1_1)
+            if (o.v1_1)
               prop(" !univ-branch");
             else
               prop(" no-univ-branch");
@@ -500,22 +516,23 @@ namespace spot
       }
     else
       {
-        if (md.is_universal && aut->is_existential())
+        if (md.is_universal && existential)
           {
             prop(" deterministic");
-            if (verbose)
+            if (o.verbose)
               prop(" !univ-branch !exist-branch");
           }
-        else
+        else if (md.exact || !existential
+                 || aut->prop_universal().is_false())
           {
             prop(" !deterministic");
-            if (!aut->is_existential())
+            if (!existential)
               prop(" univ-branch");
-            else if (verbose)
+            else if (o.verbose)
               prop(" !univ-branch");
             if (!md.is_universal)
               prop(" exist-branch");
-            else if (verbose)
+            else if (o.verbose)
               prop(" !exist-branch");
           }
       }
@@ -524,47 +541,112 @@ namespace spot
     // automata are usually concerned about non-deterministic
     // unambiguous automata.  So do not mention "unambiguous"
     // in the case of deterministic automata.
-    if (aut->prop_unambiguous() && (verbose || !md.is_universal))
+    if (aut->prop_unambiguous() && (o.verbose || !md.is_universal))
       prop(" unambiguous");
-    else if (v1_1 && !aut->prop_unambiguous())
+    else if (o.v1_1 && !aut->prop_unambiguous())
       prop(" !unambiguous");
-    if (aut->prop_semi_deterministic() && (verbose || !md.is_universal))
+    if (aut->prop_semi_deterministic() && (o.verbose || !md.is_universal))
       prop(" semi-deterministic");
-    else if (v1_1 && !aut->prop_semi_deterministic())
+    else if (o.v1_1 && !aut->prop_semi_deterministic())
       prop(" !semi-deterministic");
     if (aut->prop_stutter_invariant())
       prop(" stutter-invariant");
     if (!aut->prop_stutter_invariant())
       {
-        if (v1_1)
+        if (o.v1_1)
           prop(" !stutter-invariant");
         else
           prop(" stutter-sensitive");
       }
     if (aut->prop_terminal())
       prop(" terminal");
-    if (aut->prop_very_weak() && (verbose || aut->prop_terminal() != true))
+    if (aut->prop_very_weak() && (o.verbose || aut->prop_terminal() != true))
       prop(" very-weak");
-    if (aut->prop_weak() && (verbose || (aut->prop_terminal() != true &&
-                                         aut->prop_very_weak() != true)))
+    if (aut->prop_weak() && (o.verbose || (aut->prop_terminal() != true &&
+                                           aut->prop_very_weak() != true)))
       prop(" weak");
-    if (aut->prop_inherently_weak() && (verbose || aut->prop_weak() != true))
+    if (aut->prop_inherently_weak() && (o.verbose
+                                        || aut->prop_weak() != true))
       prop(" inherently-weak");
-    if (v1_1 && !aut->prop_terminal() && (verbose || aut->prop_weak() != false))
+    if (o.v1_1 && !aut->prop_terminal() && (o.verbose
+                                            || aut->prop_weak() != false))
       prop(" !terminal");
-    if (v1_1 && !aut->prop_very_weak() && (verbose
-                                           || aut->prop_weak() != false))
+    if (o.v1_1 && !aut->prop_very_weak() && (o.verbose
+                                             || aut->prop_weak() != false))
       prop(" !very-weak");
-    if (v1_1 && !aut->prop_weak() && (verbose ||
-                                      aut->prop_inherently_weak() != false))
+    if (o.v1_1 && !aut->prop_weak() && (o.verbose ||
+                                        aut->prop_inherently_weak() != false))
       prop(" !weak");
-    if (v1_1 && !aut->prop_inherently_weak())
+    if (o.v1_1 && !aut->prop_inherently_weak())
       prop(" !inherently-weak");
     os << nl;
+  }
+
+  // Compute the index of minterm ONE in the table of implicit labels.
+  static unsigned
+  implicit_label_pos(bdd one)
+  {
+    unsigned level = 1;
+    unsigned pos = 0U;
+    while (one != bddtrue)
+      {
+        bdd h = bdd_high(one);
+        if (h == bddfalse)
+          {
+            one = bdd_low(one);
+          }
+        else
+          {
+            pos |= level;
+            one = h;
+          }
+        level <<= 1;
+      }
+    return pos;
+  }
+
+  static std::ostream&
+  print_hoa(std::ostream& os,
+            const const_twa_graph_ptr& aut,
+            hoa_options& o)
+  {
+    metadata md(aut, o.implicit_labels, o.state_labels);
+
+    if (o.acceptance == Hoa_Acceptance_States && !md.has_state_acc)
+      o.acceptance = Hoa_Acceptance_Transitions;
+    o.implicit_labels = md.use_implicit_labels;
+    o.state_labels = md.use_state_labels;
+
+    auto print_dst = [&os, &aut](unsigned dst)
+      {
+        bool notfirst = false;
+        for (unsigned d: aut->univ_dests(dst))
+          {
+            if (notfirst)
+              os << '&';
+            else
+              notfirst = true;
+            os << d;
+          }
+      };
+
+    unsigned num_states = aut->num_states();
+    unsigned init = aut->get_init_state_number();
+
+    const char nl = o.newline ? '\n' : ' ';
+    os << (o.v1_1 ? "HOA: v1.1" : "HOA: v1") << nl;
+    auto n = aut->get_named_prop<std::string>("automaton-name");
+    if (n)
+      escape_str(os << "name: \"", *n) << '"' << nl;
+    os << "States: " << num_states << nl
+       << "Start: ";
+    print_dst(init);
+    os << nl;
+    print_hoa_header(os, aut, md, o, aut->is_existential());
 
     // highlighted states and edges are only output in the 1.1 format,
     // because we use a dot in the header name.
-    if (v1_1)
+    if (o.v1_1)
       {
         if (auto hstates = aut->get_named_prop
             <std::map<unsigned, unsigned>>("highlight-states"))
@@ -603,25 +685,28 @@ namespace spot
     // fill a vector with all destinations in order.
     std::vector<unsigned> out;
     std::vector<acc_cond::mark_t> outm;
-    if (implicit_labels)
+    if (o.implicit_labels)
       {
+        unsigned nap = md.vap.size();
         out.resize(1UL << nap);
-        if (acceptance != Hoa_Acceptance_States)
+        if (o.acceptance != Hoa_Acceptance_States)
           outm.resize(1UL << nap);
       }
 
     os << "--BODY--" << nl;
 
     auto sn = aut->get_named_prop<std::vector<std::string>>("state-names");
+    auto sp =
+      sn ? nullptr : aut->get_named_prop<string_pool>("state-name-pool");
     for (unsigned i = 0; i < num_states; ++i)
       {
-        hoa_acceptance this_acc = acceptance;
+        hoa_acceptance this_acc = o.acceptance;
         if (this_acc == Hoa_Acceptance_Mixed)
           this_acc = (md.common_acc[i] ?
                       Hoa_Acceptance_States : Hoa_Acceptance_Transitions);
 
         os << "State: ";
-        if (state_labels)
+        if (o.state_labels)
           {
             bool output = false;
             for (auto& t: aut->out(i))
@@ -636,6 +721,8 @@ namespace spot
         os << i;
         if (sn && i < sn->size() && !(*sn)[i].empty())
           os << " \"" << (*sn)[i] << '"';
+        else if (sp && i < sp->size() && sp->length(i))
+          os << " \"" << sp->c_str(i) << '"';
         if (this_acc == Hoa_Acceptance_States)
           {
             acc_cond::mark_t acc = 0U;
@@ -648,7 +735,7 @@ namespace spot
           }
         os << nl;
 
-        if (!implicit_labels && !state_labels)
+        if (!o.implicit_labels && !o.state_labels)
           {
 
             for (auto& t: aut->out(i))
@@ -660,7 +747,7 @@ namespace spot
                 os << nl;
               }
           }
-        else if (state_labels)
+        else if (o.state_labels)
           {
             unsigned n = 0;
             for (auto& t: aut->out(i))
@@ -687,22 +774,7 @@ namespace spot
                   {
                     bdd one = bdd_satoneset(cond, md.all_ap, bddfalse);
                     cond -= one;
-                    unsigned level = 1;
-                    unsigned pos = 0U;
-                    while (one != bddtrue)
-                      {
-                        bdd h = bdd_high(one);
-                        if (h == bddfalse)
-                          {
-                            one = bdd_low(one);
-                          }
-                        else
-                          {
-                            pos |= level;
-                            one = h;
-                          }
-                        level <<= 1;
-                      }
+                    unsigned pos = implicit_label_pos(one);
                     out[pos] = t.dst;
                     if (this_acc != Hoa_Acceptance_States)
                       outm[pos] = t.acc;
@@ -729,30 +801,201 @@ namespace spot
     return os;
   }
 
+  // Print an automaton that is not a twa_graph while exploring it.
+  // States are numbered in the order they are discovered by a
+  // breadth-first search (the same order as make_twa_graph()), and
+  // each state is output as soon as its successors have been
+  // numbered.  Only the numbering of the states is kept in memory,
+  // not the edges.  Since the number of states is unknown until the
+  // end, the optional "States:" header is omitted, and properties
+  // such as determinism or completeness are those declared by the
+  // automaton.
+  static std::ostream&
+  print_hoa_otf(std::ostream& os,
+                const const_twa_ptr& aut,
+                hoa_options& o)
+  {
+    // State labels can only be announced in advance for Kripke
+    // structures, where they are guaranteed to exist.
+    bool kripke = !!std::dynamic_pointer_cast<const fair_kripke>(aut);
+    metadata md(aut, o.implicit_labels, o.state_labels && kripke);
+
+    if (o.acceptance == Hoa_Acceptance_States && !md.has_state_acc)
+      o.acceptance = Hoa_Acceptance_Transitions;
+    o.implicit_labels = md.use_implicit_labels;
+    o.state_labels = md.use_state_labels;
+
+    const char nl = o.newline ? '\n' : ' ';
+    os << (o.v1_1 ? "HOA: v1.1" : "HOA: v1") << nl;
+    auto n = aut->get_named_prop<std::string>("automaton-name");
+    if (n)
+      escape_str(os << "name: \"", *n) << '"' << nl;
+    os << "Start: 0" << nl;
+    print_hoa_header(os, aut, md, o, true);
+
+    std::vector<unsigned> out;
+    std::vector<acc_cond::mark_t> outm;
+    if (o.implicit_labels)
+      {
+        unsigned nap = md.vap.size();
+        out.resize(1UL << nap);
+        if (o.acceptance != Hoa_Acceptance_States)
+          outm.resize(1UL << nap);
+      }
+
+    os << "--BODY--" << nl;
+
+    // The states in todo are also in seen.  Destroy them all on exit,
+    // including when label() throws or the stream raises an exception.
+    struct seen_store: public state_store<unsigned>
+    {
+      ~seen_store()
+      {
+        destroy_states();
+      }
+    } seen;
+    std::deque<const state*> todo;
+    auto number = [&](const state* s) -> unsigned
+      {
+        auto p = seen.emplace(s, seen.size());
+        if (p.second)
+          todo.emplace_back(s);
+        else
+          s->destroy();
+        return p.first->second;
+      };
+
+    struct out_edge
+    {
+      bdd cond;
+      unsigned dst;
+      acc_cond::mark_t acc;
+    };
+    // Successors of the current state only.
+    std::vector<out_edge> succs;
+
+    number(aut->get_init_state());
+    // Stop exploring once the stream has failed: nothing more can be
+    // written.
+    for (unsigned src = 0; !todo.empty() && os; ++src)
+      {
+        const state* s = todo.front();
+        todo.pop_front();
+        succs.clear();
+        for (auto* t: aut->succ(s))
+          succs.push_back({t->cond(), number(t->dst()), t->acc()});
+
+        acc_cond::mark_t first_acc = 0U;
+        if (!succs.empty())
+          first_acc = succs.front().acc;
+        hoa_acceptance this_acc = o.acceptance;
+        if (this_acc == Hoa_Acceptance_Mixed)
+          {
+            this_acc = Hoa_Acceptance_States;
+            for (auto& t: succs)
+              if (t.acc != first_acc)
+                {
+                  this_acc = Hoa_Acceptance_Transitions;
+                  break;
+                }
+          }
+
+        os << "State: ";
+        if (o.state_labels)
+          {
+            if (succs.empty())
+              os << "[f] ";
+            else
+              os << '[' << md.label(succs.front().cond) << "] ";
+          }
+        os << src;
+        if (this_acc == Hoa_Acceptance_States)
+          md.emit_acc(os, first_acc);
+        os << nl;
+
+        if (!o.implicit_labels && !o.state_labels)
+          {
+            for (auto& t: succs)
+              {
+                os << '[' << md.label(t.cond) << "] " << t.dst;
+                if (this_acc == Hoa_Acceptance_Transitions)
+                  md.emit_acc(os, t.acc);
+                os << nl;
+              }
+          }
+        else if (o.state_labels)
+          {
+            unsigned n = 0;
+            unsigned ns = succs.size();
+            for (auto& t: succs)
+              {
+                os << t.dst;
+                if (this_acc == Hoa_Acceptance_Transitions)
+                  {
+                    md.emit_acc(os, t.acc);
+                    os << nl;
+                  }
+                else
+                  {
+                    ++n;
+                    os << (((n & 15) && n < ns) ? ' ' : nl);
+                  }
+              }
+          }
+        else
+          {
+            for (auto& t: succs)
+              {
+                bdd cond = t.cond;
+                while (cond != bddfalse)
+                  {
+                    bdd one = bdd_satoneset(cond, md.all_ap, bddfalse);
+                    cond -= one;
+                    unsigned pos = implicit_label_pos(one);
+                    out[pos] = t.dst;
+                    if (this_acc != Hoa_Acceptance_States)
+                      outm[pos] = t.acc;
+                  }
+              }
+            unsigned n = out.size();
+            for (unsigned i = 0; i < n;)
+              {
+                os << out[i];
+                if (this_acc != Hoa_Acceptance_States)
+                  {
+                    md.emit_acc(os, outm[i]) << nl;
+                    ++i;
+                  }
+                else
+                  {
+                    ++i;
+                    os << (((i & 15) && i < n) ? ' ' : nl);
+                  }
+              }
+          }
+      }
+    os << "--END--";                // No newline.  Let the caller decide.
+    return os;
+  }
+
   std::ostream&
   print_hoa(std::ostream& os,
             const const_twa_ptr& aut,
             const char* opt)
   {
+    hoa_options o(opt);
+    // for Kripke structures, automatically enable state labels.
+    if (std::dynamic_pointer_cast<const fair_kripke>(aut))
+      o.state_labels = true;
 
     auto a = std::dynamic_pointer_cast<const twa_graph>(aut);
     if (!a)
-      a = make_twa_graph(aut, twa::prop_set::all());
-
-    // for Kripke structures, automatically append "k" to the options.
-    char* tmpopt = nullptr;
-    if (std::dynamic_pointer_cast<const fair_kripke>(aut))
       {
-        unsigned n = opt ? strlen(opt) : 0;
-        tmpopt = new char[n + 2];
-        if (opt)
-          strcpy(tmpopt, opt);
-        tmpopt[n] = 'k';
-        tmpopt[n + 1] = 0;
+        if (o.on_the_fly)
+          return print_hoa_otf(os, aut, o);
+        a = make_twa_graph(aut, twa::prop_set::all());
       }
-    print_hoa(os, a, tmpopt ? tmpopt : opt);
-    delete[] tmpopt;
-    return os;
+    return print_hoa(os, a, o);
   }
 
 }
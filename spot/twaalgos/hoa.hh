@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014, 2015 Laboratoire de Recherche et Développement
+// Copyright (C) 2014, 2015, 2018 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -36,7 +36,22 @@ namespace spot
   ///        (s) state-based acceptance when possible, (t)
   ///        transition-based acceptance, (m) mixed acceptance, (l)
   ///        single-line output, (v) verbose properties, (1.1) use
-  ///        version 1.1 of the HOA format.
+  ///        version 1.1 of the HOA format, (o) output states while
+  ///        exploring automata that are not twa_graph.
+  ///
+  /// Automata that are not twa_graph (e.g., on-the-fly products)
+  /// are normally converted into a twa_graph before being printed,
+  /// because the header has to announce the number of states and
+  /// some properties that require looking at all edges.  With
+  /// option (o), such an automaton is instead explored in
+  /// breadth-first order and each state is printed as soon as it has
+  /// been visited, so that only the numbering of states is kept in
+  /// memory.  In this mode the optional "States:" header is omitted,
+  /// properties such as "deterministic" or "complete" are only
+  /// output if the automaton declares them, and state labels (k) are
+  /// only used for Kripke structures.  The name of the automaton, if
+  /// any, is also output, while the conversion into a twa_graph loses
+  /// it.  Option (o) has no effect on twa_graph.
   SPOT_API std::ostream&
   print_hoa(std::ostream& os,
             const const_twa_ptr& g,
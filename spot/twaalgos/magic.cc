@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2013-2017  Laboratoire de recherche et
+// Copyright (C) 2011, 2013-2018  Laboratoire de recherche et
 // développement de l'Epita (LRDE).
 // Copyright (C) 2004, 2005  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -462,14 +462,7 @@ namespace spot
 
       ~explicit_magic_search_heap()
         {
-          auto s = h.begin();
-          while (s != h.end())
-            {
-              // Advance the iterator before deleting the "key" pointer.
-              const state* ptr = s->first;
-              ++s;
-              ptr->destroy();
-            }
+          h.destroy_states();
         }
 
       color_ref get_color_ref(const state*& s)
@@ -508,7 +501,7 @@ namespace spot
         }
 
     private:
-      state_map<color> h;
+      state_store<color> h;
     };
 
     class bsh_magic_search_heap final
@@ -0,0 +1,682 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE)
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <spot/twaalgos/mtec.hh>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <spot/twa/twagraph.hh>
+#include <spot/twaalgos/emptiness_stats.hh>
+
+namespace spot
+{
+  namespace
+  {
+    struct worker_stats
+    {
+      unsigned states = 0;
+      unsigned transitions = 0;
+      unsigned max_depth = 0;
+    };
+
+    // Each worker explores the successors of a state starting from
+    // a different one.  Worker 0 uses the order of the automaton,
+    // unless a seed is given.
+    class succ_order
+    {
+      std::minstd_rand gen_;
+      bool shuffle_;
+    public:
+      succ_order(unsigned seed, unsigned worker)
+        : gen_(seed * 65U + worker + 1), shuffle_(seed || worker)
+      {
+      }
+
+      unsigned start(unsigned deg)
+      {
+        return (shuffle_ && deg > 1) ? gen_() % deg : 0;
+      }
+    };
+
+    // A frame of the DFS stack of a worker: the edges of state s
+    // are those numbered b to b + deg - 1, and are explored starting
+    // from b + rot.
+    struct frame
+    {
+      unsigned v;
+      unsigned b;
+      unsigned deg;
+      unsigned rot;
+      unsigned k;
+
+      bool has_next() const
+      {
+        return k < deg;
+      }
+
+      unsigned next()
+      {
+        return b + (rot + k++) % deg;
+      }
+    };
+
+    // The counterexample is computed by a sequential algorithm.
+    class mtec_result final: public emptiness_check_result
+    {
+    public:
+      mtec_result(const const_twa_ptr& a, option_map o)
+        : emptiness_check_result(a, o)
+      {
+      }
+
+      twa_run_ptr accepting_run() override
+      {
+        return automaton()->accepting_run();
+      }
+    };
+
+    // The part common to all multi-threaded emptiness checks.  The
+    // edges of the automaton are first stored into arrays that the
+    // workers can read without touching any BDD.
+    class mtec_base: public emptiness_check, public ec_statistics
+    {
+    public:
+      mtec_base(const const_twa_graph_ptr& a, option_map o,
+                const char* name, unsigned max_threads)
+        : emptiness_check(a, o), g_(a), name_(name),
+          max_threads_(max_threads)
+      {
+      }
+
+      emptiness_check_result_ptr check() override
+      {
+        const const_twa_graph_ptr& g = g_;
+        if (!g->is_existential())
+          throw std::runtime_error(std::string(name_)
+                                   + " does not support alternation");
+        unsigned ns = g->num_states();
+        beg_.assign(ns + 1, 0);
+        for (auto& e: g->edges())
+          ++beg_[e.src + 1];
+        for (unsigned s = 0; s < ns; ++s)
+          beg_[s + 1] += beg_[s];
+        unsigned ne = beg_[ns];
+        dst_.resize(ne);
+        marks_.resize(ne);
+        {
+          std::vector<unsigned> pos(beg_.begin(), beg_.end() - 1);
+          for (auto& e: g->edges())
+            {
+              unsigned j = pos[e.src]++;
+              dst_[j] = e.dst;
+              marks_[j] = e.acc;
+            }
+        }
+        init_ = g->get_init_state_number();
+        cond_ = g->acc();
+        seed_ = o_.get("seed", 0);
+        found_.store(false);
+
+        int t = o_.get("threads", 1);
+        unsigned nthreads = parallel_policy(t > 0 ? t : 1).nthreads();
+        nthreads = std::min(nthreads, max_threads_);
+        std::vector<worker_stats> wstats(nthreads);
+        prepare(ns);
+        internal::parallel_ranges(nthreads, nthreads,
+                                  [&](unsigned i, size_t, size_t)
+                                  {
+                                    run(i, wstats[i]);
+                                  });
+        cleanup();
+        beg_ = std::vector<unsigned>();
+        dst_ = std::vector<unsigned>();
+        marks_ = std::vector<acc_cond::mark_t>();
+
+        worker_stats sum;
+        for (auto& st: wstats)
+          {
+            sum.states += st.states;
+            sum.transitions += st.transitions;
+            sum.max_depth = std::max(sum.max_depth, st.max_depth);
+          }
+        set_states(sum.states);
+        set_transitions(sum.transitions);
+        inc_depth(sum.max_depth);
+        dec_depth(sum.max_depth);
+
+        if (found_.load())
+          return std::make_shared<mtec_result>(a_, o_);
+        return nullptr;
+      }
+
+      std::ostream& print_stats(std::ostream& os) const override
+      {
+        os << states() << " states visited\n";
+        os << transitions() << " transitions explored\n";
+        os << max_depth() << " items max on stack\n";
+        return os;
+      }
+
+    protected:
+      // Allocate the shared data for an automaton of n states.
+      virtual void prepare(unsigned n) = 0;
+      // The work of worker i.
+      virtual void run(unsigned i, worker_stats& st) = 0;
+      // Release the shared data.
+      virtual void cleanup() = 0;
+
+      bool found() const
+      {
+        return found_.load(std::memory_order_relaxed);
+      }
+
+      void report()
+      {
+        found_.store(true);
+      }
+
+      const_twa_graph_ptr g_;
+      const char* name_;
+      unsigned max_threads_;
+      std::vector<unsigned> beg_;
+      std::vector<unsigned> dst_;
+      std::vector<acc_cond::mark_t> marks_;
+      unsigned init_;
+      acc_cond cond_;
+      unsigned seed_;
+      std::atomic<bool> found_;
+    };
+
+    // CNDFS works on a state-based view of the automaton: state
+    // 2s+b stands for state s reached by an edge that is accepting
+    // iff b=1.
+    class cndfs_check final: public mtec_base
+    {
+    public:
+      cndfs_check(const const_twa_graph_ptr& a, option_map o)
+        : mtec_base(a, o, "cndfs", -1U)
+      {
+        if (!(a->num_sets() == 0 || a->acc().is_buchi()))
+          throw std::runtime_error("cndfs requires Büchi automata");
+      }
+
+    protected:
+      enum : unsigned char { BLUE = 1, RED = 2 };
+
+      void prepare(unsigned n) override
+      {
+        unsigned ne = dst_.size();
+        vdst_.resize(ne);
+        for (unsigned j = 0; j < ne; ++j)
+          vdst_[j] = 2 * dst_[j] + cond_.accepting(marks_[j]);
+        nv_ = 2 * n;
+        color_.reset(new std::atomic<unsigned char>[nv_]);
+        for (unsigned v = 0; v < nv_; ++v)
+          color_[v].store(0, std::memory_order_relaxed);
+      }
+
+      void cleanup() override
+      {
+        vdst_ = std::vector<unsigned>();
+        color_.reset();
+      }
+
+      void run(unsigned p, worker_stats& st) override
+      {
+        std::vector<bool> cyan(nv_);
+        std::vector<bool> in_rs(nv_);
+        std::vector<unsigned> rs;
+        std::vector<frame> blue;
+        std::vector<frame> red;
+        succ_order order(seed_, p);
+
+        auto push = [&](std::vector<frame>& stack, unsigned v)
+          {
+            unsigned b = beg_[v / 2];
+            unsigned deg = beg_[v / 2 + 1] - b;
+            stack.push_back({v, b, deg, order.start(deg), 0});
+            unsigned depth = blue.size() + red.size();
+            if (depth > st.max_depth)
+              st.max_depth = depth;
+          };
+
+        // Returns false if an accepting cycle was found.
+        auto dfs_red = [&](unsigned v)
+          {
+            in_rs[v] = true;
+            rs.push_back(v);
+            push(red, v);
+            while (!red.empty())
+              {
+                if (found())
+                  return false;
+                frame& f = red.back();
+                if (!f.has_next())
+                  {
+                    red.pop_back();
+                    continue;
+                  }
+                unsigned t = vdst_[f.next()];
+                ++st.transitions;
+                if (cyan[t])
+                  {
+                    report();
+                    return false;
+                  }
+                if (!in_rs[t] && !(color_[t].load() & RED))
+                  {
+                    in_rs[t] = true;
+                    rs.push_back(t);
+                    push(red, t);
+                  }
+              }
+            return true;
+          };
+
+        unsigned init = 2 * init_;
+        if (color_[init].load())
+          return;
+        cyan[init] = true;
+        ++st.states;
+        push(blue, init);
+        while (!blue.empty())
+          {
+            if (found())
+              return;
+            frame& f = blue.back();
+            if (f.has_next())
+              {
+                unsigned t = vdst_[f.next()];
+                ++st.transitions;
+                if (cyan[t])
+                  {
+                    // Early detection of a cycle closed by an
+                    // accepting state.
+                    if ((f.v & 1) || (t & 1))
+                      {
+                        report();
+                        return;
+                      }
+                  }
+                else if (!color_[t].load())
+                  {
+                    cyan[t] = true;
+                    ++st.states;
+                    push(blue, t);
+                  }
+                continue;
+              }
+            unsigned v = f.v;
+            blue.pop_back();
+            color_[v].fetch_or(BLUE);
+            if (v & 1)
+              {
+                rs.clear();
+                if (!dfs_red(v))
+                  return;
+                // Wait for the other workers to finish the red
+                // searches of the accepting states we have met.
+                for (unsigned u: rs)
+                  if ((u & 1) && u != v)
+                    while (!(color_[u].load() & RED))
+                      {
+                        if (found())
+                          return;
+                        std::this_thread::yield();
+                      }
+                for (unsigned u: rs)
+                  {
+                    color_[u].fetch_or(RED);
+                    in_rs[u] = false;
+                  }
+              }
+            cyan[v] = false;
+          }
+      }
+
+    private:
+      std::vector<unsigned> vdst_;
+      unsigned nv_;
+      std::unique_ptr<std::atomic<unsigned char>[]> color_;
+    };
+
+    class ufscc_check final: public mtec_base
+    {
+    public:
+      ufscc_check(const const_twa_graph_ptr& a, option_map o)
+        : mtec_base(a, o, "ufscc", 64)
+      {
+        if (a->acc().uses_fin_acceptance())
+          throw std::runtime_error("ufscc does not support Fin acceptance");
+      }
+
+    protected:
+      enum : unsigned char { UNSEEN, LIVE, DEAD };
+
+      // A node of the concurrent union-find structure.  The fields
+      // workers, acc, and status are only meaningful for roots.  The
+      // nodes of a set whose state has not been fully explored are
+      // linked in a cyclic list through next, which is protected by
+      // the lock of the root.
+      struct uf_node
+      {
+        std::atomic<unsigned> parent;
+        std::atomic<unsigned> acc;
+        std::atomic<std::uint64_t> workers;
+        std::atomic<unsigned char> status;
+        std::atomic<bool> done;
+        std::atomic<bool> lock;
+        unsigned next;
+      };
+
+      void prepare(unsigned n) override
+      {
+        uf_.reset(new uf_node[n]);
+        for (unsigned s = 0; s < n; ++s)
+          {
+            uf_node& u = uf_[s];
+            u.parent.store(s, std::memory_order_relaxed);
+            u.acc.store(0, std::memory_order_relaxed);
+            u.workers.store(0, std::memory_order_relaxed);
+            u.status.store(UNSEEN, std::memory_order_relaxed);
+            u.done.store(false, std::memory_order_relaxed);
+            u.lock.store(false, std::memory_order_relaxed);
+            u.next = s;
+          }
+      }
+
+      void cleanup() override
+      {
+        uf_.reset();
+      }
+
+      unsigned find(unsigned x)
+      {
+        for (;;)
+          {
+            unsigned p = uf_[x].parent.load();
+            if (p == x)
+              return x;
+            unsigned gp = uf_[p].parent.load();
+            // Path halving.
+            if (p != gp)
+              uf_[x].parent.compare_exchange_weak(p, gp);
+            x = gp;
+          }
+      }
+
+      void lock(unsigned x)
+      {
+        while (uf_[x].lock.exchange(true, std::memory_order_acquire))
+          std::this_thread::yield();
+      }
+
+      void unlock(unsigned x)
+      {
+        uf_[x].lock.store(false, std::memory_order_release);
+      }
+
+      bool is_root(unsigned x)
+      {
+        return uf_[x].parent.load() == x;
+      }
+
+      // Lock the root of the set of x, and return it.
+      unsigned lock_root(unsigned x)
+      {
+        for (;;)
+          {
+            unsigned r = find(x);
+            lock(r);
+            if (is_root(r))
+              return r;
+            unlock(r);
+          }
+      }
+
+      void unite(unsigned a, unsigned b)
+      {
+        for (;;)
+          {
+            unsigned ra = find(a);
+            unsigned rb = find(b);
+            if (ra == rb)
+              return;
+            unsigned lo = std::min(ra, rb);
+            unsigned hi = std::max(ra, rb);
+            lock(lo);
+            lock(hi);
+            if (is_root(lo) && is_root(hi))
+              {
+                // The parent is changed first, so that workers and
+                // marks added to lo concurrently are seen by whoever
+                // reads them from hi after checking that hi is still
+                // a root.
+                uf_[lo].parent.store(hi);
+                uf_[hi].workers.fetch_or(uf_[lo].workers.load());
+                uf_[hi].acc.fetch_or(uf_[lo].acc.load());
+                std::swap(uf_[lo].next, uf_[hi].next);
+                unlock(hi);
+                unlock(lo);
+                return;
+              }
+            unlock(hi);
+            unlock(lo);
+          }
+      }
+
+      // Add the marks m to the set of x, and report an accepting
+      // cycle if the set is now accepting.
+      void add_acc(unsigned x, acc_cond::mark_t m)
+      {
+        unsigned r = find(x);
+        for (;;)
+          {
+            uf_[r].acc.fetch_or(m.id);
+            if (is_root(r))
+              break;
+            r = find(r);
+          }
+        if (cond_.accepting(uf_[r].acc.load()))
+          report();
+      }
+
+      enum claim_res { CLAIM_FIRST, CLAIM_SUCCESS, CLAIM_FOUND, CLAIM_DEAD };
+
+      claim_res claim(unsigned s, std::uint64_t bit)
+      {
+        unsigned char unseen = UNSEEN;
+        claim_res res = CLAIM_SUCCESS;
+        unsigned r = s;
+        if (uf_[s].status.load() == UNSEEN
+            && uf_[s].status.compare_exchange_strong(unseen, LIVE))
+          {
+            res = CLAIM_FIRST;
+          }
+        else
+          {
+            r = find(s);
+            if (uf_[r].status.load() == DEAD)
+              return CLAIM_DEAD;
+            if (uf_[r].workers.load() & bit)
+              return CLAIM_FOUND;
+          }
+        // Another worker may unite the set with another one while we
+        // add ourselves.
+        for (;;)
+          {
+            uf_[r].workers.fetch_or(bit);
+            if (is_root(r))
+              return res;
+            r = find(r);
+          }
+      }
+
+      // Return a state of the set of s that is not yet fully
+      // explored, or -1U after marking the set as dead.
+      unsigned pick_or_kill(unsigned s)
+      {
+        unsigned r = lock_root(s);
+        unsigned res = -1U;
+        if (!uf_[r].done.load())
+          {
+            res = r;
+          }
+        else
+          {
+            unsigned prev = r;
+            unsigned cur = uf_[r].next;
+            while (cur != r)
+              {
+                if (!uf_[cur].done.load())
+                  {
+                    res = cur;
+                    break;
+                  }
+                // The root is never a done state removed from the
+                // list, because it stays the root until it is
+                // united with another live set.
+                cur = uf_[prev].next = uf_[cur].next;
+              }
+            if (res == -1U)
+              uf_[r].status.store(DEAD);
+          }
+        unlock(r);
+        return res;
+      }
+
+      void run(unsigned p, worker_stats& st) override
+      {
+        std::uint64_t bit = std::uint64_t(1) << p;
+        // The roots of the partial SCCs on the DFS stack of this
+        // worker, with the marks of the edges that lead to them.
+        std::vector<std::pair<unsigned, acc_cond::mark_t>> roots;
+        // Here frame::v is the state whose set is being explored,
+        // and frame::k is -1U while no state of the set is picked.
+        std::vector<frame> todo;
+        std::vector<unsigned> picked;
+        succ_order order(seed_, p);
+
+        auto call = [&](unsigned s, acc_cond::mark_t m)
+          {
+            roots.emplace_back(s, m);
+            todo.push_back({s, 0, 0, 0, 0});
+            picked.push_back(-1U);
+            unsigned depth = todo.size();
+            if (depth > st.max_depth)
+              st.max_depth = depth;
+          };
+
+        switch (claim(init_, bit))
+          {
+          case CLAIM_FIRST:
+            ++st.states;
+            SPOT_FALLTHROUGH;
+          case CLAIM_SUCCESS:
+            call(init_, 0U);
+            break;
+          case CLAIM_FOUND:
+          case CLAIM_DEAD:
+            return;
+          }
+
+        while (!todo.empty())
+          {
+            if (found())
+              return;
+            frame& f = todo.back();
+            if (picked.back() == -1U)
+              {
+                unsigned s = pick_or_kill(f.v);
+                if (s == -1U)
+                  {
+                    if (!roots.empty()
+                        && find(roots.back().first) == find(f.v))
+                      roots.pop_back();
+                    todo.pop_back();
+                    picked.pop_back();
+                    continue;
+                  }
+                picked.back() = s;
+                f.b = beg_[s];
+                f.deg = beg_[s + 1] - f.b;
+                f.rot = order.start(f.deg);
+                f.k = 0;
+              }
+            if (!f.has_next())
+              {
+                uf_[picked.back()].done.store(true);
+                picked.back() = -1U;
+                continue;
+              }
+            unsigned j = f.next();
+            unsigned t = dst_[j];
+            ++st.transitions;
+            switch (claim(t, bit))
+              {
+              case CLAIM_DEAD:
+                break;
+              case CLAIM_FIRST:
+                ++st.states;
+                SPOT_FALLTHROUGH;
+              case CLAIM_SUCCESS:
+                call(t, marks_[j]);
+                break;
+              case CLAIM_FOUND:
+                {
+                  // t is on the stack of this worker: collapse the
+                  // partial SCCs that are above it.
+                  unsigned v = f.v;
+                  while (find(v) != find(t))
+                    {
+                      SPOT_ASSERT(roots.size() > 1);
+                      auto top = roots.back();
+                      roots.pop_back();
+                      unite(top.first, roots.back().first);
+                      add_acc(top.first, top.second);
+                    }
+                  add_acc(t, marks_[j]);
+                  break;
+                }
+              }
+          }
+      }
+
+    private:
+      std::unique_ptr<uf_node[]> uf_;
+    };
+  }
+
+  emptiness_check_ptr
+  cndfs(const const_twa_graph_ptr& a, option_map o)
+  {
+    return std::make_shared<cndfs_check>(a, o);
+  }
+
+  emptiness_check_ptr
+  ufscc(const const_twa_graph_ptr& a, option_map o)
+  {
+    return std::make_shared<ufscc_check>(a, o);
+  }
+}
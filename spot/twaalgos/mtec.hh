@@ -0,0 +1,112 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE)
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/misc/optionmap.hh>
+#include <spot/twa/fwd.hh>
+#include <spot/twaalgos/emptiness.hh>
+
+namespace spot
+{
+  /// \addtogroup emptiness_check_algorithms
+  /// @{
+
+  /// \brief Returns a multi-threaded emptiness check for Büchi
+  /// automata, based on the CNDFS algorithm.
+  ///
+  /// Several workers run a nested depth-first search, each one
+  /// ordering the successors of the states differently, and share
+  /// the colors of the states they have completely explored.  The
+  /// first worker to find an accepting cycle stops all the others.
+  /// The algorithm is described in the following paper.
+  ///
+  /// \verbatim
+  /// @InProceedings{evangelista.12.atva,
+  ///   author    = {Sami Evangelista and Alfons Laarman and Laure
+  ///                Petrucci and Jaco van de Pol},
+  ///   title     = {Improved Multi-Core Nested Depth-First Search},
+  ///   booktitle = {Proceedings of the 10th International Symposium on
+  ///                Automated Technology for Verification and Analysis
+  ///                (ATVA'12)},
+  ///   year      = {2012},
+  ///   pages     = {269--283},
+  ///   series    = {Lecture Notes in Computer Science},
+  ///   volume    = {7561},
+  ///   publisher = {Springer}
+  /// }
+  /// \endverbatim
+  ///
+  /// The automaton should use Büchi acceptance (transition-based
+  /// acceptance is supported), or no acceptance set at all.
+  ///
+  /// The following options are supported:
+  ///   - \c threads the number of workers (default: 1).  Only one
+  ///     worker is used if Spot was built without thread support.
+  ///   - \c seed a seed used to order the successors of the states
+  ///     differently in each worker (default: 0).
+  ///
+  /// The workers do not call the successor iterators of \a a, as
+  /// these use BDDs, which can only be manipulated by the thread
+  /// that created them: they read the edges of \a a instead.  This
+  /// is why this check is not on-the-fly, and only accepts a
+  /// twa_graph.  To check an on-the-fly product, build it first
+  /// with make_twa_graph() or product(), knowing that this costs as
+  /// much memory as the whole product.  A counterexample is computed
+  /// by a sequential algorithm when
+  /// emptiness_check_result::accepting_run() is called.
+  ///
+  /// Unlike the other emptiness checks, this one cannot be obtained
+  /// from make_emptiness_check_instantiator(), whose checks all
+  /// work on any twa.
+  SPOT_API emptiness_check_ptr
+  cndfs(const const_twa_graph_ptr& a, option_map o = option_map());
+
+  /// \brief Returns a multi-threaded emptiness check for
+  /// generalized Büchi automata, based on the UFSCC algorithm.
+  ///
+  /// Several workers compute the strongly connected components of
+  /// the automaton with a depth-first search, sharing the partial
+  /// components they discover in a concurrent union-find structure.
+  /// An accepting cycle is reported as soon as the union of the
+  /// acceptance marks seen in a partial component is accepting.
+  /// The algorithm is described in the following paper.
+  ///
+  /// \verbatim
+  /// @InProceedings{bloemen.16.ppopp,
+  ///   author    = {Vincent Bloemen and Alfons Laarman and Jaco van
+  ///                de Pol},
+  ///   title     = {Multi-Core On-The-Fly {SCC} Decomposition},
+  ///   booktitle = {Proceedings of the 21st ACM SIGPLAN Symposium on
+  ///                Principles and Practice of Parallel Programming
+  ///                (PPoPP'16)},
+  ///   year      = {2016},
+  ///   pages     = {8:1--8:12},
+  ///   publisher = {ACM}
+  /// }
+  /// \endverbatim
+  ///
+  /// The automaton may use any Fin-less acceptance condition.  The
+  /// options and the restrictions are the same as for cndfs(), with
+  /// at most 64 workers.
+  SPOT_API emptiness_check_ptr
+  ufscc(const const_twa_graph_ptr& a, option_map o = option_map());
+
+  /// @}
+}
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2009, 2011, 2012, 2014, 2015, 2016 Laboratoire de
+// Copyright (C) 2009, 2011, 2012, 2014-2016, 2018 Laboratoire de
 // Recherche et Développement de l'Epita (LRDE).
 // Copyright (C) 2004 Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -27,6 +27,7 @@
 #include <spot/twa/twagraph.hh>
 #include <spot/twaalgos/reachiter.hh>
 #include <spot/tl/print.hh>
+#include <spot/misc/strpool.hh>
 #include <spot/twa/formula2bdd.hh>
 
 namespace spot
@@ -39,6 +40,7 @@ namespace spot
       std::ostream& os_;
       bool opt_comments_ = false;
       std::vector<std::string>* sn_ = nullptr;
+      string_pool* sp_ = nullptr;
       bool opt_624_ = false;
       const_twa_graph_ptr aut_;
       bool fi_needed_ = false;
@@ -100,8 +102,15 @@ namespace spot
       print_comment(unsigned n) const
       {
         if (sn_)
-          if (n < sn_->size() && !(*sn_)[n].empty())
-            os_ << " /* " << (*sn_)[n] << " */";
+          {
+            if (n < sn_->size() && !(*sn_)[n].empty())
+              os_ << " /* " << (*sn_)[n] << " */";
+          }
+        else if (sp_)
+          {
+            if (n < sp_->size() && sp_->length(n))
+              os_ << " /* " << sp_->c_str(n) << " */";
+          }
       }
 
       void
@@ -188,7 +197,11 @@ namespace spot
       {
         aut_ = aut;
         if (opt_comments_)
-          sn_ = aut->get_named_prop<std::vector<std::string>>("state-names");
+          {
+            sn_ = aut->get_named_prop<std::vector<std::string>>("state-names");
+            if (!sn_)
+              sp_ = aut->get_named_prop<string_pool>("state-name-pool");
+          }
         start();
         unsigned init = aut_->get_init_state_number();
         unsigned ns = aut_->num_states();
@@ -81,6 +81,7 @@ namespace spot
         sat_states_ = opt->get("sat-states", 0);
         state_based_ = opt->get("state-based", 0);
         wdba_minimize_ = opt->get("wdba-minimize", 1);
+        arena_ = opt->get("arena", 0);
 
         if (sat_acc_ && sat_minimize_ == 0)
           sat_minimize_ = 1;        // Dicho.
@@ -187,6 +188,12 @@ namespace spot
 
   twa_graph_ptr
   postprocessor::run(twa_graph_ptr a, formula f)
+  {
+    return run_in_arena_([&]() { return run_(a, f); });
+  }
+
+  twa_graph_ptr
+  postprocessor::run_(twa_graph_ptr a, formula f)
   {
     if (simul_ < 0)
       simul_ = (level_ == Low) ? 1 : 3;
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <spot/twa/twagraph.hh>
+#include <spot/misc/memres.hh>
 
 namespace spot
 {
@@ -216,9 +217,32 @@ namespace spot
     ///
     /// The returned automaton might be a new automaton,
     /// or an in-place modification of the \a input automaton.
+    ///
+    /// If the "arena" option is set, the automata created during
+    /// the processing are allocated in a monotonic_buffer_resource
+    /// that is released at the end, and only the returned automaton
+    /// is moved to the default memory resource.
     twa_graph_ptr run(twa_graph_ptr input, formula f = nullptr);
 
   protected:
+    twa_graph_ptr run_(twa_graph_ptr input, formula f);
+
+    // Call fun(), using a temporary arena as the default memory
+    // resource if the "arena" option is set.  The automaton
+    // returned by fun() is moved out of the arena.
+    template <typename Fun>
+    twa_graph_ptr run_in_arena_(Fun fun)
+    {
+      if (!arena_)
+        return fun();
+      monotonic_buffer_resource arena(1 << 16);
+      default_resource_scope scope(&arena);
+      twa_graph_ptr res = fun();
+      if (res)
+        res->get_graph().set_memory_resource(scope.previous());
+      return res;
+    }
+
     twa_graph_ptr do_simul(const twa_graph_ptr& input, int opt);
     twa_graph_ptr do_sba_simul(const twa_graph_ptr& input, int opt);
     twa_graph_ptr do_degen(const twa_graph_ptr& input);
@@ -250,6 +274,7 @@ namespace spot
     int sat_states_ = 0;
     bool state_based_ = false;
     bool wdba_minimize_ = true;
+    bool arena_ = false;
   };
   /// @}
 }
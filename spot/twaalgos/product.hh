@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014, 2015 Laboratoire de Recherche et
+// Copyright (C) 2014, 2015, 2018 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -42,9 +42,19 @@ namespace spot
   /// "product-states" with type spot::product_states.  This stores
   /// the pair of original state numbers associated to each state of
   /// the product.
+  ///
+  /// The product is built by a breadth-first search.  By default,
+  /// this search is sequential.  If \a ppolicy allows several
+  /// threads, the search continues in parallel, one level at a
+  /// time, as soon as it reaches a level of at least 1024 states
+  /// per thread (or the grain of \a ppolicy, if set).  The result,
+  /// including the numbering of its states and edges, is the same as
+  /// with a single thread.  Only the calling thread manipulates
+  /// BDDs.
   SPOT_API
   twa_graph_ptr product(const const_twa_graph_ptr& left,
-                        const const_twa_graph_ptr& right);
+                        const const_twa_graph_ptr& right,
+                        parallel_policy ppolicy = parallel_policy());
 
   /// \ingroup twa_algorithms
   /// \brief Intersect two automata using a synchronous product
@@ -66,7 +76,8 @@ namespace spot
   twa_graph_ptr product(const const_twa_graph_ptr& left,
                         const const_twa_graph_ptr& right,
                         unsigned left_state,
-                        unsigned right_state);
+                        unsigned right_state,
+                        parallel_policy ppolicy = parallel_policy());
 
   /// \ingroup twa_algorithms
   /// \brief Sum two automata using a synchronous product
@@ -82,7 +93,8 @@ namespace spot
   /// the product.
   SPOT_API
   twa_graph_ptr product_or(const const_twa_graph_ptr& left,
-                           const const_twa_graph_ptr& right);
+                           const const_twa_graph_ptr& right,
+                           parallel_policy ppolicy = parallel_policy());
 
   /// \ingroup twa_algorithms
   /// \brief Sum two automata using a synchronous product
@@ -104,6 +116,7 @@ namespace spot
   twa_graph_ptr product_or(const const_twa_graph_ptr& left,
                            const const_twa_graph_ptr& right,
                            unsigned left_state,
-                           unsigned right_state);
+                           unsigned right_state,
+                           parallel_policy ppolicy = parallel_policy());
 
 }
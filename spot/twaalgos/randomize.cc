@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2017 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2018 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -22,6 +22,7 @@
 #include <random>
 #include <spot/twaalgos/randomize.hh>
 #include <spot/misc/random.hh>
+#include <spot/misc/strpool.hh>
 
 namespace spot
 {
@@ -54,6 +55,8 @@ namespace spot
               (*nn)[nums[i]] = (*sn)[i];
             aut->set_named_prop("state-names", nn);
           }
+        if (auto sp = aut->get_named_prop<string_pool>("state-name-pool"))
+          *sp = sp->renumbered(nums, n);
         if (auto hs = aut->get_named_prop<std::map<unsigned, unsigned>>
             ("highlight-states"))
           {
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2009-2017 Laboratoire de Recherche et Développement
+// Copyright (C) 2009-2018 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -20,6 +20,7 @@
 #include <spot/twaalgos/sccfilter.hh>
 #include <spot/twaalgos/reachiter.hh>
 #include <spot/twaalgos/sccinfo.hh>
+#include <spot/misc/strpool.hh>
 
 namespace spot
 {
@@ -349,6 +350,11 @@ namespace spot
                 (*new_names)[new_s] = (*names)[s];
             }
         }
+      if (auto* pool = aut->get_named_prop<string_pool>("state-name-pool"))
+        {
+          auto* new_pool = new string_pool(pool->renumbered(inout, out_n));
+          filtered->set_named_prop("state-name-pool", new_pool);
+        }
       if (auto hs =
           aut->get_named_prop<std::map<unsigned, unsigned>>("highlight-states"))
         {
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2017 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2018 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -20,10 +20,13 @@
 #include <spot/twaalgos/sccinfo.hh>
 #include <stack>
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <spot/twa/bddprint.hh>
 #include <spot/twaalgos/mask.hh>
 #include <spot/misc/escape.hh>
+#include <spot/priv/parallel.hh>
 
 
 namespace spot
@@ -69,7 +72,8 @@ namespace spot
                      unsigned initial_state,
                      edge_filter filter,
                      void* filter_data,
-                     scc_info_options options)
+                     scc_info_options options,
+                     parallel_policy ppolicy)
     : aut_(aut), initial_state_(initial_state),
       filter_(filter), filter_data_(filter_data),
       options_(options)
@@ -86,6 +90,18 @@ namespace spot
         && aut->acc().uses_fin_acceptance())
       options_ = options = options | scc_info_options::TRACK_STATES;
 
+    if (!!(options & scc_info_options::PARALLEL) && !filter
+        && !(options & scc_info_options::STOP_ON_ACC)
+        && internal::parallel_threads(ppolicy, n) > 1)
+      {
+        if (initial_state_ == -1U)
+          initial_state_ = aut->get_init_state_number();
+        parallel_scc_(ppolicy);
+        if (!!(options & scc_info_options::TRACK_SUCCS))
+          determine_usefulness();
+        return;
+      }
+
     std::vector<unsigned> live;
     live.reserve(n);
     std::deque<scc> root_;        // Stack of SCC roots.
@@ -352,6 +368,646 @@ namespace spot
       determine_usefulness();
   }
 
+  namespace
+  {
+    // Raise V to X if it is smaller.  Return true if V was changed.
+    static bool atomic_raise(std::atomic<unsigned>& v, unsigned x)
+    {
+      unsigned cur = v.load(std::memory_order_relaxed);
+      while (cur < x)
+        if (v.compare_exchange_weak(cur, x, std::memory_order_relaxed))
+          return true;
+      return false;
+    }
+
+    // Replace RES by the concatenation of PARTS.
+    static void concat(std::vector<unsigned>& res,
+                       const std::vector<std::vector<unsigned>>& parts)
+    {
+      res.clear();
+      for (auto& p: parts)
+        res.insert(res.end(), p.begin(), p.end());
+    }
+  }
+
+  // The parallel algorithm works in two steps.
+  //
+  // First, the reachable states are partitioned into SCCs.  Each
+  // SCC is designated by its largest state, called its
+  // representative.  States that have no predecessor or no
+  // successor among the remaining states are trimmed as trivial
+  // SCCs, and the SCC of the state with the most neighbors is found
+  // with a forward and a backward search.  Then each remaining
+  // state is colored by the largest state that can reach it, and
+  // each state whose color is itself is the representative of the
+  // SCC formed by the states of that color that can reach it.
+  // These states are removed, and the coloring is repeated.  When
+  // few states remain, or when the coloring takes too many passes
+  // (e.g., on long chains), the remaining states are handled by a
+  // sequential Tarjan on the reversed graph.
+  //
+  // Second, the SCCs are sorted by height in the SCC graph (the
+  // length of the longest path to a terminal SCC), then by
+  // representative.  This is a reverse topological order that does
+  // not depend on the number of threads, and where the SCC of the
+  // initial state comes last.
+  //
+  // None of this uses BDDs, so it is safe to run in worker threads.
+  void scc_info::parallel_scc_(parallel_policy ppolicy)
+  {
+    auto& gr = aut_->get_graph();
+    unsigned n = gr.num_states();
+    bool track_states = !!(options_ & scc_info_options::TRACK_STATES);
+    bool track_succs = !!(options_ & scc_info_options::TRACK_SUCCS);
+    const acc_cond& acccond = aut_->acc();
+
+    // The coloring is abandoned after that many passes, and the loop
+    // after that many rounds.
+    const unsigned max_passes = 32;
+    const unsigned max_rounds = 32;
+
+    // 0 for states not yet reached, 1 for reachable states whose SCC
+    // is unknown, 2 for states whose SCC is known.
+    std::unique_ptr<std::atomic<unsigned>[]>
+      status(new std::atomic<unsigned>[n]);
+    for (unsigned s = 0; s < n; ++s)
+      status[s].store(0, std::memory_order_relaxed);
+
+    auto claim = [&](unsigned s, unsigned from, unsigned to)
+      {
+        return status[s].load(std::memory_order_relaxed) == from
+          && status[s].compare_exchange_strong(from, to,
+                                               std::memory_order_relaxed);
+      };
+
+    // Compute the set of reachable states with a level-synchronous
+    // BFS.
+    std::vector<unsigned> active;
+    {
+      std::vector<unsigned> frontier;
+      for (unsigned s: aut_->univ_dests(initial_state_))
+        if (claim(s, 0, 1))
+          frontier.push_back(s);
+      while (!frontier.empty())
+        {
+          active.insert(active.end(), frontier.begin(), frontier.end());
+          size_t fs = frontier.size();
+          unsigned nt = internal::parallel_threads(ppolicy, fs);
+          std::vector<std::vector<unsigned>> next(nt);
+          internal::parallel_ranges
+            (nt, fs, [&](unsigned i, size_t b, size_t e)
+             {
+               auto& nx = next[i];
+               for (size_t j = b; j < e; ++j)
+                 for (auto& t: gr.out(frontier[j]))
+                   for (unsigned d: aut_->univ_dests(t.dst))
+                     if (claim(d, 0, 1))
+                       nx.push_back(d);
+             });
+          concat(frontier, next);
+        }
+    }
+    unsigned nthreads = internal::parallel_threads(ppolicy, active.size());
+
+    // Count the predecessors and successors of each state, and
+    // build the reversed graph.  COLOR is used as a cursor to fill
+    // REV.
+    std::unique_ptr<std::atomic<unsigned>[]>
+      indeg(new std::atomic<unsigned>[n]);
+    std::unique_ptr<std::atomic<unsigned>[]>
+      outdeg(new std::atomic<unsigned>[n]);
+    std::unique_ptr<std::atomic<unsigned>[]>
+      color(new std::atomic<unsigned>[n]);
+    internal::parallel_ranges
+      (nthreads, active.size(), [&](unsigned, size_t b, size_t e)
+       {
+         for (size_t j = b; j < e; ++j)
+           indeg[active[j]].store(0, std::memory_order_relaxed);
+       });
+    internal::parallel_ranges
+      (nthreads, active.size(), [&](unsigned, size_t b, size_t e)
+       {
+         for (size_t j = b; j < e; ++j)
+           {
+             unsigned s = active[j];
+             unsigned out = 0;
+             for (auto& t: gr.out(s))
+               for (unsigned d: aut_->univ_dests(t.dst))
+                 {
+                   ++out;
+                   indeg[d].fetch_add(1, std::memory_order_relaxed);
+                 }
+             outdeg[s].store(out, std::memory_order_relaxed);
+           }
+       });
+    std::vector<unsigned> rbeg(n + 1);
+    for (unsigned s = 0; s < n; ++s)
+      {
+        unsigned in = 0;
+        if (status[s].load(std::memory_order_relaxed))
+          {
+            in = indeg[s].load(std::memory_order_relaxed);
+            color[s].store(rbeg[s], std::memory_order_relaxed);
+          }
+        rbeg[s + 1] = rbeg[s] + in;
+      }
+    std::vector<unsigned> rev(rbeg[n]);
+    internal::parallel_ranges
+      (nthreads, active.size(), [&](unsigned, size_t b, size_t e)
+       {
+         for (size_t j = b; j < e; ++j)
+           {
+             unsigned s = active[j];
+             for (auto& t: gr.out(s))
+               for (unsigned d: aut_->univ_dests(t.dst))
+                 rev[color[d].fetch_add(1, std::memory_order_relaxed)] = s;
+           }
+       });
+
+    // The representative of the SCC of each reachable state.  It is
+    // written by the thread that sets the status of the state to 2.
+    std::vector<unsigned> rep(n, -1U);
+
+    // Update the degrees of the neighbors of S, which has just been
+    // removed.  If TODO is given, neighbors that become trivial are
+    // removed as well, and pushed to TODO.
+    auto release = [&](unsigned s, std::vector<unsigned>* todo)
+      {
+        for (auto& t: gr.out(s))
+          for (unsigned d: aut_->univ_dests(t.dst))
+            if (indeg[d].fetch_sub(1, std::memory_order_relaxed) == 1
+                && todo && claim(d, 1, 2))
+              todo->push_back(d);
+        for (unsigned i = rbeg[s]; i < rbeg[s + 1]; ++i)
+          {
+            unsigned p = rev[i];
+            if (outdeg[p].fetch_sub(1, std::memory_order_relaxed) == 1
+                && todo && claim(p, 1, 2))
+              todo->push_back(p);
+          }
+      };
+
+    // Remove trivial SCCs, and compact ACTIVE.
+    auto trim = [&]()
+      {
+        internal::parallel_ranges
+          (nthreads, active.size(), [&](unsigned, size_t b, size_t e)
+           {
+             std::vector<unsigned> todo;
+             for (size_t j = b; j < e; ++j)
+               {
+                 unsigned s = active[j];
+                 if ((indeg[s].load(std::memory_order_relaxed) == 0
+                      || outdeg[s].load(std::memory_order_relaxed) == 0)
+                     && claim(s, 1, 2))
+                   todo.push_back(s);
+                 while (!todo.empty())
+                   {
+                     unsigned r = todo.back();
+                     todo.pop_back();
+                     rep[r] = r;
+                     release(r, &todo);
+                   }
+               }
+           });
+        std::vector<std::vector<unsigned>> left(nthreads);
+        internal::parallel_ranges
+          (nthreads, active.size(), [&](unsigned i, size_t b, size_t e)
+           {
+             for (size_t j = b; j < e; ++j)
+               if (status[active[j]].load(std::memory_order_relaxed) == 1)
+                 left[i].push_back(active[j]);
+           });
+        concat(active, left);
+        nthreads = internal::parallel_threads(ppolicy, active.size());
+      };
+
+    // Color each active state by the largest active state that can
+    // reach it.  Return false if this takes too many passes.
+    auto colorize = [&]()
+      {
+        internal::parallel_ranges
+          (nthreads, active.size(), [&](unsigned, size_t b, size_t e)
+           {
+             for (size_t j = b; j < e; ++j)
+               color[active[j]].store(active[j], std::memory_order_relaxed);
+           });
+        for (unsigned pass = 0; pass < max_passes; ++pass)
+          {
+            std::atomic<bool> changed(false);
+            // Alternate the direction of the passes, so that colors
+            // travel quickly along both increasing and decreasing
+            // sequences of states.
+            bool backward = pass & 1;
+            internal::parallel_ranges
+              (nthreads, active.size(), [&](unsigned, size_t b, size_t e)
+               {
+                 bool ch = false;
+                 for (size_t k = b; k < e; ++k)
+                   {
+                     unsigned s = active[backward ? b + e - 1 - k : k];
+                     unsigned c = color[s].load(std::memory_order_relaxed);
+                     for (auto& t: gr.out(s))
+                       for (unsigned d: aut_->univ_dests(t.dst))
+                         if (status[d].load(std::memory_order_relaxed) == 1)
+                           ch |= atomic_raise(color[d], c);
+                   }
+                 if (ch)
+                   changed.store(true, std::memory_order_relaxed);
+               });
+            if (!changed.load(std::memory_order_relaxed))
+              return true;
+          }
+        return false;
+      };
+
+    // Remove the SCC of each state whose color is itself.
+    auto extract = [&]()
+      {
+        std::vector<std::vector<unsigned>> roots(nthreads);
+        internal::parallel_ranges
+          (nthreads, active.size(), [&](unsigned i, size_t b, size_t e)
+           {
+             for (size_t j = b; j < e; ++j)
+               if (color[active[j]].load(std::memory_order_relaxed)
+                   == active[j])
+                 roots[i].push_back(active[j]);
+           });
+        std::vector<unsigned> allroots;
+        concat(allroots, roots);
+        // Reuse ROOTS to hold the removed states.
+        internal::parallel_ranges
+          (nthreads, allroots.size(), [&](unsigned i, size_t b, size_t e)
+           {
+             auto& removed = roots[i];
+             removed.clear();
+             std::vector<unsigned> todo;
+             for (size_t j = b; j < e; ++j)
+               {
+                 unsigned r = allroots[j];
+                 status[r].store(2, std::memory_order_relaxed);
+                 rep[r] = r;
+                 removed.push_back(r);
+                 todo.push_back(r);
+                 while (!todo.empty())
+                   {
+                     unsigned s = todo.back();
+                     todo.pop_back();
+                     for (unsigned k = rbeg[s]; k < rbeg[s + 1]; ++k)
+                       {
+                         unsigned p = rev[k];
+                         if (color[p].load(std::memory_order_relaxed) == r
+                             && claim(p, 1, 2))
+                           {
+                             rep[p] = r;
+                             removed.push_back(p);
+                             todo.push_back(p);
+                           }
+                       }
+                   }
+               }
+           });
+        for (auto& removed: roots)
+          internal::parallel_ranges
+            (internal::parallel_threads(ppolicy, removed.size()),
+             removed.size(), [&](unsigned, size_t b, size_t e)
+             {
+               for (size_t j = b; j < e; ++j)
+                 release(removed[j], nullptr);
+             });
+      };
+
+    // Remove the SCC of the active state with the most neighbors,
+    // by searching forward from it, and then backward among the
+    // states reached forward (marked with status 3).  This quickly
+    // gets rid of the giant SCC that many automata have.
+    auto pivot = [&]()
+      {
+        unsigned pv = active[0];
+        unsigned best = 0;
+        for (unsigned s: active)
+          {
+            unsigned deg = indeg[s].load(std::memory_order_relaxed)
+              + outdeg[s].load(std::memory_order_relaxed);
+            if (deg > best)
+              {
+                best = deg;
+                pv = s;
+              }
+          }
+        auto search = [&](unsigned from, unsigned to, bool forward,
+                          std::vector<unsigned>& seen)
+          {
+            std::vector<unsigned> frontier = { pv };
+            while (!frontier.empty())
+              {
+                seen.insert(seen.end(), frontier.begin(), frontier.end());
+                size_t fs = frontier.size();
+                unsigned nt = internal::parallel_threads(ppolicy, fs);
+                std::vector<std::vector<unsigned>> next(nt);
+                internal::parallel_ranges
+                  (nt, fs, [&](unsigned i, size_t b, size_t e)
+                   {
+                     auto& nx = next[i];
+                     for (size_t j = b; j < e; ++j)
+                       {
+                         unsigned s = frontier[j];
+                         if (forward)
+                           {
+                             for (auto& t: gr.out(s))
+                               for (unsigned d: aut_->univ_dests(t.dst))
+                                 if (claim(d, from, to))
+                                   nx.push_back(d);
+                           }
+                         else
+                           {
+                             for (unsigned k = rbeg[s]; k < rbeg[s + 1]; ++k)
+                               if (claim(rev[k], from, to))
+                                 nx.push_back(rev[k]);
+                           }
+                       }
+                   });
+                concat(frontier, next);
+              }
+          };
+        std::vector<unsigned> fwd;
+        std::vector<unsigned> scc;
+        status[pv].store(3, std::memory_order_relaxed);
+        search(1, 3, true, fwd);
+        status[pv].store(2, std::memory_order_relaxed);
+        search(3, 2, false, scc);
+        unsigned r = *std::max_element(scc.begin(), scc.end());
+        internal::parallel_ranges
+          (internal::parallel_threads(ppolicy, scc.size()),
+           scc.size(), [&](unsigned, size_t b, size_t e)
+           {
+             for (size_t j = b; j < e; ++j)
+               {
+                 rep[scc[j]] = r;
+                 release(scc[j], nullptr);
+               }
+           });
+        internal::parallel_ranges
+          (internal::parallel_threads(ppolicy, fwd.size()),
+           fwd.size(), [&](unsigned, size_t b, size_t e)
+           {
+             for (size_t j = b; j < e; ++j)
+               claim(fwd[j], 3, 1);
+           });
+      };
+
+    // Tarjan's algorithm on the remaining states, following the
+    // edges backward.
+    auto tarjan = [&]()
+      {
+        std::vector<unsigned> idx(n, 0);
+        std::vector<unsigned> low(n);
+        std::vector<unsigned> stack;
+        std::vector<std::pair<unsigned, unsigned>> todo; // state, pos
+        unsigned count = 0;
+        for (unsigned s0: active)
+          {
+            if (idx[s0])
+              continue;
+            idx[s0] = low[s0] = ++count;
+            stack.push_back(s0);
+            todo.emplace_back(s0, rbeg[s0]);
+            while (!todo.empty())
+              {
+                unsigned s = todo.back().first;
+                unsigned pos = todo.back().second;
+                if (pos < rbeg[s + 1])
+                  {
+                    ++todo.back().second;
+                    unsigned p = rev[pos];
+                    if (status[p].load(std::memory_order_relaxed) != 1)
+                      continue;
+                    if (!idx[p])
+                      {
+                        idx[p] = low[p] = ++count;
+                        stack.push_back(p);
+                        todo.emplace_back(p, rbeg[p]);
+                      }
+                    else
+                      {
+                        low[s] = std::min(low[s], idx[p]);
+                      }
+                    continue;
+                  }
+                todo.pop_back();
+                if (!todo.empty())
+                  {
+                    unsigned& l = low[todo.back().first];
+                    l = std::min(l, low[s]);
+                  }
+                if (low[s] != idx[s])
+                  continue;
+                auto b = stack.end();
+                while (*--b != s)
+                  continue;
+                unsigned r = *std::max_element(b, stack.end());
+                for (auto i = b; i != stack.end(); ++i)
+                  {
+                    rep[*i] = r;
+                    status[*i].store(2, std::memory_order_relaxed);
+                  }
+                stack.erase(b, stack.end());
+              }
+          }
+      };
+
+    trim();
+    if (nthreads > 1 && !active.empty())
+      {
+        pivot();
+        trim();
+      }
+    for (unsigned round = 0; !active.empty(); ++round)
+      {
+        if (nthreads <= 1 || round >= max_rounds || !colorize())
+          {
+            tarjan();
+            break;
+          }
+        extract();
+        trim();
+      }
+
+    std::vector<unsigned>().swap(rev);
+    std::vector<unsigned>().swap(rbeg);
+
+    // Give the SCCs temporary numbers, by increasing
+    // representatives, and list the states of each SCC in
+    // increasing order.
+    unsigned nscc = 0;
+    std::vector<unsigned> tmpnum(n);
+    for (unsigned s = 0; s < n; ++s)
+      if (rep[s] == s)
+        tmpnum[s] = nscc++;
+    nthreads = internal::parallel_threads(ppolicy, n);
+    internal::parallel_ranges
+      (nthreads, n, [&](unsigned, size_t b, size_t e)
+       {
+         for (size_t s = b; s < e; ++s)
+           if (rep[s] != -1U && rep[s] != s)
+             tmpnum[s] = tmpnum[rep[s]];
+       });
+    std::vector<unsigned> mbeg(nscc + 1, 0);
+    for (unsigned s = 0; s < n; ++s)
+      if (rep[s] != -1U)
+        ++mbeg[tmpnum[s] + 1];
+    for (unsigned t = 0; t < nscc; ++t)
+      mbeg[t + 1] += mbeg[t];
+    std::vector<unsigned> members(mbeg[nscc]);
+    {
+      std::vector<unsigned> pos(mbeg.begin(), mbeg.end() - 1);
+      for (unsigned s = 0; s < n; ++s)
+        if (rep[s] != -1U)
+          members[pos[tmpnum[s]]++] = s;
+    }
+
+    // Gather the information about each SCC.  The successors are
+    // always computed, because we need them to order the SCCs.
+    std::vector<scc_node> nodes(nscc);
+    internal::parallel_ranges
+      (nthreads, nscc, [&](unsigned, size_t b, size_t e)
+       {
+         for (size_t t = b; t < e; ++t)
+           {
+             auto& nd = nodes[t];
+             acc_cond::mark_t acc = 0U;
+             acc_cond::mark_t common = -1U;
+             bool triv = true;
+             bool accepting = false;
+             for (unsigned k = mbeg[t]; k < mbeg[t + 1]; ++k)
+               {
+                 unsigned s = members[k];
+                 for (auto& tr: gr.out(s))
+                   for (unsigned d: aut_->univ_dests(tr.dst))
+                     {
+                       unsigned u = tmpnum[d];
+                       if (u != t)
+                         {
+                           nd.succ_.push_back(u);
+                           continue;
+                         }
+                       acc |= tr.acc;
+                       common &= tr.acc;
+                       triv = false;
+                       // A self-loop is an accepting cycle on its own.
+                       if (d == s && !accepting)
+                         accepting = acccond.accepting(tr.acc);
+                     }
+               }
+             auto& succ = nd.succ_;
+             std::sort(succ.begin(), succ.end());
+             succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+             nd.acc_ = acc;
+             nd.common_ = common;
+             nd.trivial_ = triv;
+             nd.accepting_ = !triv && (accepting || acccond.accepting(acc));
+             nd.rejecting_ = triv
+               || acccond.maybe_accepting(acc, common).is_false();
+             nd.one_state_ = members[mbeg[t + 1] - 1];
+             if (track_states)
+               nd.states_.assign(members.begin() + mbeg[t],
+                                 members.begin() + mbeg[t + 1]);
+           }
+       });
+
+    // Order the SCCs by height.  Terminal SCCs have height 0, and
+    // an SCC of height h is processed once all its successors have
+    // been processed, during level h.
+    std::unique_ptr<std::atomic<unsigned>[]>
+      pending(new std::atomic<unsigned>[nscc]);
+    std::vector<unsigned> pbeg(nscc + 1, 0);
+    std::vector<unsigned> frontier;
+    for (unsigned t = 0; t < nscc; ++t)
+      {
+        unsigned ns = nodes[t].succ_.size();
+        pending[t].store(ns, std::memory_order_relaxed);
+        if (!ns)
+          frontier.push_back(t);
+        for (unsigned u: nodes[t].succ_)
+          ++pbeg[u + 1];
+      }
+    for (unsigned t = 0; t < nscc; ++t)
+      pbeg[t + 1] += pbeg[t];
+    std::vector<unsigned> preds(pbeg[nscc]);
+    {
+      std::vector<unsigned> pos(pbeg.begin(), pbeg.end() - 1);
+      for (unsigned t = 0; t < nscc; ++t)
+        for (unsigned u: nodes[t].succ_)
+          preds[pos[u]++] = t;
+    }
+    std::vector<unsigned> order;
+    order.reserve(nscc);
+    while (!frontier.empty())
+      {
+        size_t fs = frontier.size();
+        unsigned nt = internal::parallel_threads(ppolicy, fs);
+        internal::parallel_sort(frontier.begin(), frontier.end(),
+                                std::less<unsigned>(), nt);
+        order.insert(order.end(), frontier.begin(), frontier.end());
+        std::vector<std::vector<unsigned>> next(nt);
+        internal::parallel_ranges
+          (nt, fs, [&](unsigned i, size_t b, size_t e)
+           {
+             for (size_t j = b; j < e; ++j)
+               {
+                 unsigned t = frontier[j];
+                 for (unsigned k = pbeg[t]; k < pbeg[t + 1]; ++k)
+                   {
+                     unsigned p = preds[k];
+                     if (pending[p].fetch_sub(1, std::memory_order_relaxed)
+                         == 1)
+                       next[i].push_back(p);
+                   }
+               }
+           });
+        concat(frontier, next);
+      }
+    assert(order.size() == nscc);
+
+    // Renumber everything.
+    std::vector<unsigned> num(nscc);
+    for (unsigned i = 0; i < nscc; ++i)
+      num[order[i]] = i;
+    node_.resize(nscc);
+    internal::parallel_ranges
+      (nthreads, nscc, [&](unsigned, size_t b, size_t e)
+       {
+         for (size_t t = b; t < e; ++t)
+           {
+             auto& succ = nodes[t].succ_;
+             if (track_succs)
+               {
+                 for (auto& u: succ)
+                   u = num[u];
+                 std::sort(succ.begin(), succ.end());
+               }
+             else
+               {
+                 scc_succs().swap(succ);
+               }
+             node_[num[t]] = std::move(nodes[t]);
+           }
+       });
+    internal::parallel_ranges
+      (nthreads, n, [&](unsigned, size_t b, size_t e)
+       {
+         for (size_t s = b; s < e; ++s)
+           if (rep[s] != -1U)
+             sccof_[s] = num[tmpnum[s]];
+       });
+    for (unsigned i = nscc; i-- > 0;)
+      if (node_[i].accepting_)
+        {
+          one_acc_scc_ = i;
+          break;
+        }
+  }
+
   void scc_info::determine_usefulness()
   {
     // An SCC is useful if it is not rejecting or it has a successor
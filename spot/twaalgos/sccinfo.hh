@@ -323,6 +323,17 @@ namespace spot
     /// Conditionally track states if the acceptance conditions uses Fin.
     /// This is sufficiant for determine_unknown_acceptance().
     TRACK_STATES_IF_FIN_USED = 8,
+    /// Compute the SCCs with a parallel algorithm, using the number
+    /// of threads allowed by the parallel_policy given to the
+    /// constructor.  This is ignored if an edge filter is given, if
+    /// STOP_ON_ACC is set, or if the automaton is too small to
+    /// benefit from several threads.  The SCCs are still numbered
+    /// in reverse topological order, but this order (and the
+    /// state returned by one_state_of()) may differ from the one
+    /// computed by the sequential algorithm.  On automata using Fin
+    /// acceptance, more SCCs may be neither known to be accepting
+    /// nor known to be rejecting; see determine_unknown_acceptance().
+    PARALLEL = 16,
     /// Default behavior: explore everything and track states and succs.
     ALL = TRACK_STATES | TRACK_SUCCS,
   };
@@ -429,21 +440,28 @@ namespace spot
     [[noreturn]] static void report_need_track_states();
     [[noreturn]] static void report_need_track_succs();
     [[noreturn]] static void report_incompatible_stop_on_acc();
+
+    // Fill sccof_ and node_ using several threads.
+    void parallel_scc_(parallel_policy ppolicy);
 #endif
 
   public:
     /// @{
     /// \brief Create the scc_info map for \a aut
+    ///
+    /// \a ppolicy is only used with scc_info_options::PARALLEL.
     scc_info(const_twa_graph_ptr aut,
              // Use ~0U instead of -1U to work around a bug in Swig.
              // See https://github.com/swig/swig/issues/993
              unsigned initial_state = ~0U,
              edge_filter filter = nullptr,
              void* filter_data = nullptr,
-             scc_info_options options = scc_info_options::ALL);
+             scc_info_options options = scc_info_options::ALL,
+             parallel_policy ppolicy = parallel_policy());
 
-    scc_info(const_twa_graph_ptr aut, scc_info_options options)
-      : scc_info(aut, ~0U, nullptr, nullptr, options)
+    scc_info(const_twa_graph_ptr aut, scc_info_options options,
+             parallel_policy ppolicy = parallel_policy())
+      : scc_info(aut, ~0U, nullptr, nullptr, options, ppolicy)
       {
       }
     /// @}
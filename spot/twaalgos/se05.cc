@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2013-2017  Laboratoire de Recherche et
+// Copyright (C) 2011, 2013-2018  Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 // Copyright (C) 2004, 2005  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -441,54 +441,30 @@ namespace spot
 
     class explicit_se05_search_heap final
     {
-      typedef state_set hcyan_type;
-      typedef state_map<color> hash_type;
     public:
       enum { Safe = 1 };
 
       class color_ref final
       {
       public:
-        color_ref(hash_type* h, hcyan_type* hc, const state* s)
-          : is_cyan(true), ph(h), phc(hc), ps(s), pc(nullptr)
-          {
-          }
-        color_ref(color* c)
-          : is_cyan(false), ph(nullptr), phc(nullptr), ps(nullptr), pc(c)
+        color_ref(color* c) :p(c)
           {
           }
         color get_color() const
           {
-            if (is_cyan)
-              return CYAN;
-            return *pc;
+            return *p;
           }
         void set_color(color c)
           {
             assert(!is_white());
-            if (is_cyan)
-              {
-                assert(c != CYAN);
-                int i = phc->erase(ps);
-                assert(i == 1);
-                (void)i;
-                ph->emplace(ps, c);
-              }
-            else
-              {
-                *pc=c;
-              }
+            *p=c;
           }
         bool is_white() const
           {
-            return !is_cyan && !pc;
+            return !p;
           }
       private:
-        bool is_cyan;
-        hash_type* ph; //point to the main hash table
-        hcyan_type* phc; // point to the hash table hcyan
-        const state* ps; // point to the state in hcyan
-        color *pc; // point to the color of a state stored in main hash table
+        color *p;
       };
 
       explicit_se05_search_heap(size_t)
@@ -497,52 +473,26 @@ namespace spot
 
       ~explicit_se05_search_heap()
         {
-          hcyan_type::const_iterator sc = hc.begin();
-          while (sc != hc.end())
-            {
-              const state* ptr = *sc;
-              ++sc;
-              ptr->destroy();
-            }
-          hash_type::const_iterator s = h.begin();
-          while (s != h.end())
-            {
-              const state* ptr = s->first;
-              ++s;
-              ptr->destroy();
-            }
+          h.destroy_states();
         }
 
       color_ref get_color_ref(const state*& s)
         {
-          hcyan_type::iterator ic = hc.find(s);
-          if (ic == hc.end())
-            {
-              hash_type::iterator it = h.find(s);
-              if (it == h.end())
-                return color_ref(nullptr); // white state
-              if (s != it->first)
-                {
-                  s->destroy();
-                  s = it->first;
-                }
-              return color_ref(&it->second); // blue or red state
-            }
-          if (s != *ic)
+          auto it = h.find(s);
+          if (it == h.end())
+            return color_ref(nullptr); // white state
+          if (s != it->first)
             {
               s->destroy();
-              s = *ic;
+              s = it->first;
             }
-          return color_ref(&h, &hc, *ic); // cyan state
+          return color_ref(&it->second); // cyan, blue or red state
         }
 
       void add_new_state(const state* s, color c)
         {
-          assert(hc.find(s) == hc.end() && h.find(s) == h.end());
-          if (c == CYAN)
-            hc.insert(s);
-          else
-            h.emplace(s, c);
+          assert(h.find(s) == h.end());
+          h.emplace(s, c);
         }
 
       void pop_notify(const state*) const
@@ -551,25 +501,18 @@ namespace spot
 
       bool has_been_visited(const state* s) const
         {
-          hcyan_type::const_iterator ic = hc.find(s);
-          if (ic == hc.end())
-            {
-              hash_type::const_iterator it = h.find(s);
-              return (it != h.end());
-            }
-          return true;
+          return h.find(s) != h.end();
         }
 
       enum { Has_Size = 1 };
       int size() const
         {
-          return h.size() + hc.size();
+          return h.size();
         }
 
     private:
-
-      hash_type h; // associate to each blue and red state its color
-      hcyan_type hc; // associate to each cyan state its weight
+      // associate to each cyan, blue, and red state its color
+      state_store<color> h;
     };
 
     class bsh_se05_search_heap final
@@ -18,10 +18,13 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <queue>
+#include <vector>
 #include <map>
 #include <utility>
 #include <cmath>
 #include <limits>
+#include <stdexcept>
+#include <string>
 #include <spot/twaalgos/simulation.hh>
 #include <spot/misc/minato.hh>
 #include <spot/twa/bddprint.hh>
@@ -119,6 +122,17 @@ namespace spot
       int states;
     };
 
+    // Report the failure of a call to bdd_applyarray().
+    static void check_applyarray(int err)
+    {
+      if (SPOT_UNLIKELY(err))
+        {
+          const char* msg = bdd_errstring(err);
+          throw std::runtime_error(std::string("simulation: ")
+                                   + (msg ? msg : "BDD error"));
+        }
+    }
+
     // The direct_simulation. If Cosimulation is true, we are doing a
     // cosimulation.
     template <bool Cosimulation, bool Sba>
@@ -319,19 +333,37 @@ namespace spot
       // Take a state and compute its signature.
       bdd compute_sig(unsigned src)
       {
-        bdd res = bddfalse;
-
+        // The signature is the disjunction, over all outgoing edges,
+        // of the conjunction of the acceptance condition, the label
+        // of the edge and the class of the destination and all the
+        // class it implies.  These operations are done by batches
+        // with bdd_applyarray().
+        sig_left_.clear();
+        sig_right_.clear();
+        sig_acc_.clear();
         for (auto& t: a_->out(src))
           {
-            bdd acc = mark_to_bdd(t.acc);
-
-            // to_add is a conjunction of the acceptance condition,
-            // the label of the edge and the class of the
-            // destination and all the class it implies.
-            bdd to_add = acc & t.cond & relation_[previous_class_[t.dst]];
-
-            res |= to_add;
+            sig_left_.emplace_back(t.cond);
+            sig_right_.emplace_back(relation_[previous_class_[t.dst]]);
+            sig_acc_.emplace_back(mark_to_bdd(t.acc));
+          }
+        unsigned n = sig_left_.size();
+        bdd* terms = sig_left_.data();
+        check_applyarray(bdd_applyarray(terms, sig_right_.data(), terms,
+                                        n, bddop_and));
+        check_applyarray(bdd_applyarray(terms, sig_acc_.data(), terms,
+                                        n, bddop_and));
+        // Combine the terms as a balanced tree of disjunctions.
+        while (n > 1)
+          {
+            unsigned half = n / 2;
+            n -= half;
+            check_applyarray(bdd_applyarray(terms, terms + n, terms,
+                                            half, bddop_or));
           }
+        bdd res = bddfalse;
+        if (n)
+          res = terms[0];
 
         // When we Cosimulate, we add a special flag to differentiate
         // the initial state from the other.
@@ -705,6 +737,12 @@ namespace spot
 
       bdd all_proms_;
 
+      // Operands of the batched operations of compute_sig(), kept
+      // here to reuse their storage.
+      std::vector<bdd> sig_left_;
+      std::vector<bdd> sig_right_;
+      std::vector<bdd> sig_acc_;
+
       automaton_size stat;
 
       const const_twa_graph_ptr original_;
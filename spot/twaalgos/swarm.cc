@@ -0,0 +1,447 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE)
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <spot/twaalgos/swarm.hh>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <spot/twa/twa.hh>
+#include <spot/twaalgos/emptiness_stats.hh>
+#include <spot/misc/memusage.hh>
+#if HAVE_FORK
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <signal.h>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+#if HAVE_SETRLIMIT
+#  include <sys/resource.h>
+#endif
+
+namespace spot
+{
+  namespace
+  {
+#if HAVE_FORK
+    // The number of threads of the current process, or -1 if it
+    // cannot be found.
+    static int
+    thread_count()
+    {
+      FILE* file = fopen("/proc/self/status", "r");
+      if (!file)
+        return -1;
+      int res = -1;
+      char line[256];
+      while (fgets(line, sizeof line, file))
+        if (!strncmp(line, "Threads:", 8))
+          {
+            if (sscanf(line + 8, "%d", &res) != 1)
+              res = -1;
+            break;
+          }
+      (void) fclose(file);
+      return res;
+    }
+
+    // A pipe whose descriptors are not inherited by the programs
+    // that other parts of the process may execute.
+    static int
+    cloexec_pipe(int p[2])
+    {
+#  if HAVE_PIPE2
+      return pipe2(p, O_CLOEXEC);
+#  else
+      if (pipe(p))
+        return -1;
+      fcntl(p[0], F_SETFD, FD_CLOEXEC);
+      fcntl(p[1], F_SETFD, FD_CLOEXEC);
+      return 0;
+#  endif
+    }
+#endif
+
+    // An iterator over the successors of a state, in a random
+    // order.
+    class shuffled_succ_iterator final: public twa_succ_iterator
+    {
+      struct succ
+      {
+        const state* dst;
+        bdd cond;
+        acc_cond::mark_t acc;
+      };
+      std::vector<succ> succs_;
+      unsigned pos_ = 0;
+
+    public:
+      shuffled_succ_iterator(const const_twa_ptr& aut, const state* s,
+                             std::minstd_rand& gen)
+      {
+        twa_succ_iterator* it = aut->succ_iter(s);
+        if (it->first())
+          do
+            succs_.push_back({it->dst(), it->cond(), it->acc()});
+          while (it->next());
+        aut->release_iter(it);
+        for (unsigned i = succs_.size(); i > 1; --i)
+          std::swap(succs_[i - 1], succs_[gen() % i]);
+      }
+
+      ~shuffled_succ_iterator()
+      {
+        for (auto& s: succs_)
+          s.dst->destroy();
+      }
+
+      bool first() override
+      {
+        pos_ = 0;
+        return !done();
+      }
+
+      bool next() override
+      {
+        ++pos_;
+        return !done();
+      }
+
+      bool done() const override
+      {
+        return pos_ >= succs_.size();
+      }
+
+      const state* dst() const override
+      {
+        return succs_[pos_].dst->clone();
+      }
+
+      bdd cond() const override
+      {
+        return succs_[pos_].cond;
+      }
+
+      acc_cond::mark_t acc() const override
+      {
+        return succs_[pos_].acc;
+      }
+    };
+
+    // A view of an automaton where the successors of each state are
+    // listed in a pseudo-random order.  The states are those of the
+    // original automaton, so that a run of this view is also a run
+    // of the original automaton.
+    class shuffled_twa final: public twa
+    {
+      const_twa_ptr aut_;
+      mutable std::minstd_rand gen_;
+
+    public:
+      shuffled_twa(const const_twa_ptr& aut, unsigned seed)
+        : twa(aut->get_dict()), aut_(aut), gen_(seed)
+      {
+        copy_ap_of(aut);
+        copy_acceptance_of(aut);
+        prop_copy(aut, twa::prop_set::all());
+      }
+
+      const state* get_init_state() const override
+      {
+        return aut_->get_init_state();
+      }
+
+      twa_succ_iterator* succ_iter(const state* s) const override
+      {
+        return new shuffled_succ_iterator(aut_, s, gen_);
+      }
+
+      std::string format_state(const state* s) const override
+      {
+        return aut_->format_state(s);
+      }
+    };
+
+    typedef emptiness_check_ptr (*ec_constructor)(const const_twa_ptr&,
+                                                  option_map);
+
+    // The search of worker number i.
+    emptiness_check_ptr
+    make_worker(const const_twa_ptr& a, ec_constructor construct,
+                const option_map& o, unsigned i)
+    {
+      unsigned seed = o.get("seed", 0) + i;
+      if (seed == 0)
+        return construct(a, o);
+      return construct(std::make_shared<shuffled_twa>(a, seed), o);
+    }
+
+    class swarm_result final: public emptiness_check_result
+    {
+      ec_constructor construct_;
+      unsigned worker_;
+
+    public:
+      swarm_result(const const_twa_ptr& a, option_map o,
+                   ec_constructor construct, unsigned worker)
+        : emptiness_check_result(a, o), construct_(construct),
+          worker_(worker)
+      {
+      }
+
+      twa_run_ptr accepting_run() override
+      {
+        // The searches are deterministic, so doing again the search
+        // of the worker that found a counterexample finds it again.
+        auto ec = make_worker(automaton(), construct_, options(), worker_);
+        auto res = ec->check();
+        if (!res)
+          return nullptr;
+        auto run = res->accepting_run();
+        if (run)
+          run->aut = automaton();
+        return run;
+      }
+    };
+
+    class swarm final: public emptiness_check, public ec_statistics
+    {
+      ec_constructor construct_;
+      bool safe_;
+      unsigned workers_ = 0;
+      unsigned decider_ = -1U;
+
+    public:
+      swarm(const const_twa_ptr& a, ec_constructor construct, option_map o)
+        : emptiness_check(a, o), construct_(construct)
+      {
+        // Construct the first worker here, so that the errors of
+        // the search (e.g., an unsupported acceptance condition) are
+        // raised by the calling process.
+        safe_ = make_worker(a, construct, o, 0)->safe();
+      }
+
+      bool safe() const override
+      {
+        return safe_;
+      }
+
+      std::ostream& print_stats(std::ostream& os) const override
+      {
+        os << workers_ << " workers started\n";
+        if (decider_ != -1U)
+          os << "worker " << decider_ << " decided\n";
+        os << states() << " states visited by this worker\n";
+        os << transitions() << " transitions explored by this worker\n";
+        os << max_depth() << " items max on its stack\n";
+        return os;
+      }
+
+#if HAVE_FORK
+    private:
+      enum worker_status { EMPTY, NONEMPTY, OUT_OF_MEMORY, FAILED };
+
+      struct report
+      {
+        int status;
+        unsigned states;
+        unsigned transitions;
+        unsigned max_depth;
+      };
+
+      // The work of a child process.
+      report run(unsigned i)
+      {
+        report r = { FAILED, 0, 0, 0 };
+        try
+          {
+#if HAVE_SETRLIMIT
+            if (int mb = o_.get("swarm_mem", 0))
+              {
+                rlim_t lim = rlim_t(mb) << 20;
+                int pages = memusage();
+                if (pages > 0)
+                  lim += rlim_t(pages) * sysconf(_SC_PAGESIZE);
+                rlimit rl;
+                rl.rlim_cur = rl.rlim_max = lim;
+                setrlimit(RLIMIT_AS, &rl);
+              }
+#endif
+            auto ec = make_worker(a_, construct_, o_, i);
+            r.status = ec->check() ? NONEMPTY : EMPTY;
+            if (auto st = ec->emptiness_check_statistics())
+              {
+                r.states = st->states();
+                r.transitions = st->transitions();
+                r.max_depth = st->max_depth();
+              }
+          }
+        catch (const std::bad_alloc&)
+          {
+            r.status = OUT_OF_MEMORY;
+          }
+        catch (...)
+          {
+          }
+        return r;
+      }
+
+    public:
+      emptiness_check_result_ptr check() override
+      {
+        // Only the forking thread exists in the child processes: a
+        // lock held by another thread (in malloc(), in the BDD
+        // library, or anywhere else) would never be released there.
+        // So refuse to fork unless we know that we are alone.
+        int threads = thread_count();
+        if (threads < 0)
+          throw std::runtime_error("swarm_check() cannot count the "
+                                   "threads of this process");
+        if (threads > 1)
+          throw std::runtime_error("swarm_check() cannot be used while "
+                                   "other threads are running");
+        int n = o_.get("swarm", 2);
+        workers_ = n > 1 ? n : 1;
+        decider_ = -1U;
+        std::vector<pid_t> pids;
+        std::vector<pollfd> fds;
+        for (unsigned i = 0; i < workers_; ++i)
+          {
+            int p[2];
+            pid_t pid = -1;
+            if (cloexec_pipe(p) == 0)
+              {
+                pid = fork();
+                if (pid < 0)
+                  {
+                    close(p[0]);
+                    close(p[1]);
+                  }
+              }
+            if (pid < 0)
+              {
+                for (pid_t c: pids)
+                  kill(c, SIGKILL);
+                for (pid_t c: pids)
+                  waitpid(c, nullptr, 0);
+                for (auto& f: fds)
+                  close(f.fd);
+                throw std::runtime_error("swarm: failed to start worker");
+              }
+            if (pid == 0)
+              {
+                close(p[0]);
+                for (auto& f: fds)
+                  close(f.fd);
+                report r = run(i);
+                ssize_t res = write(p[1], &r, sizeof r);
+                _exit(res == sizeof r ? 0 : 1);
+              }
+            close(p[1]);
+            pids.push_back(pid);
+            fds.push_back({p[0], POLLIN, 0});
+          }
+
+        // Wait for a worker to decide the result.  A worker whose
+        // search is unsafe can only decide that the automaton is not
+        // empty.
+        report best = { FAILED, 0, 0, 0 };
+        bool decided = false;
+        bool out_of_memory = false;
+        unsigned live = workers_;
+        while (live && !decided)
+          {
+            if (poll(fds.data(), fds.size(), -1) < 0)
+              {
+                if (errno == EINTR)
+                  continue;
+                break;
+              }
+            for (unsigned i = 0; i < workers_ && !decided; ++i)
+              {
+                if (fds[i].fd < 0 || !fds[i].revents)
+                  continue;
+                report r;
+                if (read(fds[i].fd, &r, sizeof r) != sizeof r)
+                  r.status = FAILED;
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                --live;
+                if (r.status == OUT_OF_MEMORY)
+                  out_of_memory = true;
+                if (r.status == NONEMPTY || (r.status == EMPTY && safe_))
+                  decided = true;
+                if (decided || (r.status == EMPTY
+                                && (best.status != EMPTY
+                                    || r.states > best.states)))
+                  {
+                    best = r;
+                    decider_ = i;
+                  }
+              }
+          }
+        for (unsigned i = 0; i < workers_; ++i)
+          if (fds[i].fd >= 0)
+            {
+              kill(pids[i], SIGKILL);
+              close(fds[i].fd);
+            }
+        for (pid_t c: pids)
+          waitpid(c, nullptr, 0);
+
+        if (best.status == FAILED)
+          {
+            if (out_of_memory)
+              throw std::bad_alloc();
+            throw std::runtime_error("swarm: all workers failed");
+          }
+        set_states(best.states);
+        set_transitions(best.transitions);
+        inc_depth(best.max_depth);
+        dec_depth(best.max_depth);
+        if (best.status == NONEMPTY)
+          return std::make_shared<swarm_result>(a_, o_, construct_,
+                                                decider_);
+        return nullptr;
+      }
+#else
+      emptiness_check_result_ptr check() override
+      {
+        throw std::runtime_error("swarm_check() requires fork()");
+      }
+#endif
+    };
+  }
+
+  emptiness_check_ptr
+  swarm_check(const const_twa_ptr& a,
+              emptiness_check_ptr (*construct)(const const_twa_ptr&,
+                                               option_map),
+              option_map o)
+  {
+    return std::make_shared<swarm>(a, construct, o);
+  }
+}
@@ -0,0 +1,76 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE)
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/misc/optionmap.hh>
+#include <spot/twa/fwd.hh>
+#include <spot/twaalgos/emptiness.hh>
+
+namespace spot
+{
+  /// \addtogroup emptiness_check_algorithms
+  /// @{
+
+  /// \brief Run several independent copies of an emptiness check.
+  ///
+  /// This implements the "swarm verification" idea of Holzmann et
+  /// al.: \a construct is used to build one emptiness check per
+  /// worker, and each worker explores the successors of the states
+  /// of \a a in its own pseudo-random order.  The first worker to
+  /// find a counterexample stops the others.  The workers are
+  /// separate processes, so any automaton can be checked (the BDD
+  /// library and most state spaces are not thread-safe), but this
+  /// requires fork().  Because a forked process only contains the
+  /// thread that called fork(), check() throws std::runtime_error
+  /// if other threads are running in the process: call it before
+  /// starting any thread.  The threads are counted by reading
+  /// /proc/self/status, and check() also throws if this file cannot
+  /// be read (e.g., on systems without a Linux-like /proc).
+  ///
+  /// This is most useful with incomplete searches such as
+  /// magic_search() or se05() with bit-state hashing: each worker
+  /// uses its own table, and the workers together cover more of the
+  /// state space than a single one would.  The swarm is safe (see
+  /// emptiness_check::safe()) iff the checks it runs are: in that
+  /// case, the first worker that completes its search decides the
+  /// result.
+  ///
+  /// The options in \a o are passed to \a construct, and the
+  /// following ones are used by the swarm:
+  ///   - \c swarm the number of workers (default: 2).
+  ///   - \c seed the seed of the first worker (default: 0).  Worker
+  ///     \c i uses <code>seed + i</code>, and the seed 0 stands for
+  ///     the original order of the successors.
+  ///   - \c swarm_mem the memory budget of each worker, in
+  ///     megabytes (default: 0, meaning no limit).  A worker that
+  ///     exceeds its budget is abandoned.  If all workers fail
+  ///     this way, check() throws std::bad_alloc.
+  ///
+  /// Calling emptiness_check_result::accepting_run() on the result
+  /// repeats the search of the worker that found the counterexample,
+  /// sequentially.
+  SPOT_API emptiness_check_ptr
+  swarm_check(const const_twa_ptr& a,
+              emptiness_check_ptr (*construct)(const const_twa_ptr&,
+                                               option_map),
+              option_map o = option_map());
+
+  /// @}
+}
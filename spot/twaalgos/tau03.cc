@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2013-2017  Laboratoire de Recherche et
+// Copyright (C) 2011, 2013-2018  Laboratoire de Recherche et
 // Developpement de l'Epita (LRDE).
 // Copyright (C) 2004, 2005  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -321,14 +321,7 @@ namespace spot
 
       ~explicit_tau03_search_heap()
         {
-          auto s = h.begin();
-          while (s != h.end())
-            {
-              // Advance the iterator before deleting the "key" pointer.
-              const state* ptr = s->first;
-              ++s;
-              ptr->destroy();
-            }
+          h.destroy_states();
         }
 
       color_ref get_color_ref(const state*& s)
@@ -347,9 +340,7 @@ namespace spot
       void add_new_state(const state* s, color c)
         {
           assert(h.find(s) == h.end());
-          h.emplace(std::piecewise_construct,
-                    std::forward_as_tuple(s),
-                    std::forward_as_tuple(c, 0U));
+          h.emplace(s, c, 0U);
         }
 
       void pop_notify(const state*) const
@@ -367,7 +358,7 @@ namespace spot
           return h.size();
         }
     private:
-      state_map<std::pair<color, acc_cond::mark_t>> h;
+      state_store<std::pair<color, acc_cond::mark_t>> h;
     };
 
   } // anonymous
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2013-2017  Laboratoire de Recherche et
+// Copyright (C) 2011, 2013-2018  Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 // Copyright (C) 2004, 2005  Laboratoire d'Informatique de Paris 6 (LIP6),
 // département Systèmes Répartis Coopératifs (SRC), Université Pierre
@@ -399,8 +399,8 @@ namespace spot
 
     class explicit_tau03_opt_search_heap final
     {
-      typedef state_map<std::pair<weight, acc_cond::mark_t>> hcyan_type;
-      typedef state_map<std::pair<color, acc_cond::mark_t>> hash_type;
+      typedef state_store<std::pair<weight, acc_cond::mark_t>> hcyan_type;
+      typedef state_store<std::pair<color, acc_cond::mark_t>> hash_type;
     public:
       class color_ref final
       {
@@ -431,8 +431,7 @@ namespace spot
             if (is_cyan)
               {
                 assert(c != CYAN);
-                std::pair<hash_type::iterator, bool> p;
-                p = ph->emplace(ps, std::make_pair(c, *acc));
+                auto p = ph->emplace(ps, c, *acc);
                 assert(p.second);
                 acc = &(p.first->second.second);
                 int i = phc->erase(ps);
@@ -475,20 +474,8 @@ namespace spot
 
       ~explicit_tau03_opt_search_heap()
         {
-          hcyan_type::const_iterator sc = hc.begin();
-          while (sc != hc.end())
-            {
-              const state* ptr = sc->first;
-              ++sc;
-              ptr->destroy();
-            }
-          hash_type::const_iterator s = h.begin();
-          while (s != h.end())
-            {
-              const state* ptr = s->first;
-              ++s;
-              ptr->destroy();
-            }
+          hc.destroy_states();
+          h.destroy_states();
         }
 
       color_ref get_color_ref(const state*& s)
@@ -523,9 +510,7 @@ namespace spot
           assert(hc.find(s) == hc.end() && h.find(s) == h.end());
           assert(c == CYAN);
           (void)c;
-          hc.emplace(std::piecewise_construct,
-                     std::forward_as_tuple(s),
-                     std::forward_as_tuple(w, 0U));
+          hc.emplace(s, w, 0U);
         }
 
       void pop_notify(const state*) const
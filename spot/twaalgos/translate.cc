@@ -94,6 +94,11 @@ namespace spot
   }
 
   twa_graph_ptr translator::run(formula* f)
+  {
+    return run_in_arena_([&]() { return run_(f); });
+  }
+
+  twa_graph_ptr translator::run_(formula* f)
   {
     bool unambiguous = (pref_ & postprocessor::Unambiguous);
     if (unambiguous && type_ == postprocessor::Monitor)
@@ -171,7 +176,7 @@ namespace spot
                              unambiguous);
       }
 
-    aut = this->postprocessor::run(aut, r);
+    aut = this->postprocessor::run_(aut, r);
 
     if (!m.empty())
       relabel_here(aut, &m);
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014, 2015, 2016 Laboratoire de Recherche et
+// Copyright (C) 2014-2016, 2018 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -31,6 +31,7 @@
 #include <spot/twaalgos/gtec/gtec.hh>
 #include <spot/twaalgos/dot.hh>
 #include <spot/twaalgos/emptiness.hh>
+#include <spot/twaalgos/mtec.hh>
 
 static void
 syntax(char* prog)
@@ -113,7 +114,7 @@ main(int argc, char** argv)
       const char* algos[] = {
         "Cou99", "Cou99(shy)",
         "CVWY90", "CVWY90(bsh=10M)", "CVWY90(repeated)",
-        "SE05", "SE05(bsh=10M)", "SE05(repeated)",
+        "SE05", "SE05(bsh=10M)", "SE05(repeated)", "SE05(swarm=2)",
         "Tau03_opt", "GV04",
       };
 
@@ -196,6 +197,49 @@ main(int argc, char** argv)
                 }
             }
         }
+
+      // The multi-threaded checks only accept twa_graph, so they
+      // cannot be obtained from make_emptiness_check_instantiator().
+      spot::option_map opt;
+      opt.set("threads", 2);
+      for (unsigned j = 1; j < sizeof(aut)/sizeof(*aut); ++j)
+        {
+          auto a = std::dynamic_pointer_cast<const spot::twa_graph>(aut[j]);
+          assert(a);
+          for (int algo = 0; algo < 2; ++algo)
+            {
+              std::cout << "** Testing aut[" << j << "] using "
+                        << (algo ? "ufscc" : "cndfs") << "(threads=2)\n";
+              if (!algo && a->num_sets() > 1)
+                {
+                  std::cout << "Skipping because automaton has "
+                            << a->num_sets() << " acceptance sets.\n";
+                  continue;
+                }
+              auto ec = algo ? spot::ufscc(a, opt) : spot::cndfs(a, opt);
+              if (auto res = ec->check())
+                {
+                  std::cout << "1 counterexample found\n";
+                  if (auto run = res->accepting_run())
+                    spot::print_dot(std::cout, run->as_twa());
+                  std::cout << '\n';
+                  if (runs == 0)
+                    {
+                      std::cerr << "ERROR: Expected no counterexample.\n";
+                      exit(1);
+                    }
+                }
+              else
+                {
+                  std::cout << "No counterexample found.\n\n";
+                  if (runs)
+                    {
+                      std::cerr << "ERROR: expected a counterexample.\n";
+                      exit(1);
+                    }
+                }
+            }
+        }
     }
 
   assert(spot::fnode::instances_check());
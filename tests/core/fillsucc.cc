@@ -0,0 +1,332 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Explore twa_graph, kripke_graph, and products of those with each
+// other and with automata whose iterators do not support fill_succ(),
+// and print the successors of each reachable state.  With "bulk",
+// successors are listed with fill_succ(); with "iter", they are
+// listed with first()/next().  Both listings should be identical.
+//
+// Without a second argument, small automata built below are
+// explored.  Otherwise, the argument is the number of random seeds
+// to use.
+
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <spot/twa/twagraph.hh>
+#include <spot/twa/twaproduct.hh>
+#include <spot/twa/bddprint.hh>
+#include <spot/kripke/kripkegraph.hh>
+#include <spot/twaalgos/randomgraph.hh>
+#include <spot/twaalgos/ltl2taa.hh>
+#include <spot/tl/apcollect.hh>
+#include <spot/misc/random.hh>
+
+namespace
+{
+  int live_states = 0;
+
+  // A state of another automaton, counting its instances.
+  class counted_state final: public spot::state
+  {
+  public:
+    explicit counted_state(const spot::state* s)
+      : s_(s)
+    {
+      ++live_states;
+    }
+
+    int compare(const spot::state* other) const override
+    {
+      return s_->compare(static_cast<const counted_state*>(other)->s_);
+    }
+
+    size_t hash() const override
+    {
+      return s_->hash();
+    }
+
+    counted_state* clone() const override
+    {
+      return new counted_state(s_->clone());
+    }
+
+    const spot::state* inner() const
+    {
+      return s_;
+    }
+
+  private:
+    ~counted_state()
+    {
+      s_->destroy();
+      --live_states;
+    }
+
+    const spot::state* s_;
+  };
+
+  // An iterator over the successors of a counted_state.  It does not
+  // implement fill_succ().
+  class counted_succ_iterator final: public spot::twa_succ_iterator
+  {
+  public:
+    counted_succ_iterator(spot::const_twa_ptr aut,
+                          spot::twa_succ_iterator* it)
+      : aut_(aut), it_(it)
+    {
+    }
+
+    ~counted_succ_iterator()
+    {
+      aut_->release_iter(it_);
+    }
+
+    bool first() override
+    {
+      return it_->first();
+    }
+
+    bool next() override
+    {
+      return it_->next();
+    }
+
+    bool done() const override
+    {
+      return it_->done();
+    }
+
+    const spot::state* dst() const override
+    {
+      return new counted_state(it_->dst());
+    }
+
+    bdd cond() const override
+    {
+      return it_->cond();
+    }
+
+    spot::acc_cond::mark_t acc() const override
+    {
+      return it_->acc();
+    }
+
+  private:
+    spot::const_twa_ptr aut_;
+    spot::twa_succ_iterator* it_;
+  };
+
+  // An automaton that behaves like AUT, but whose states must be
+  // destroyed and are counted.
+  class counted_twa final: public spot::twa
+  {
+  public:
+    explicit counted_twa(const spot::const_twa_ptr& aut)
+      : twa(aut->get_dict()), aut_(aut)
+    {
+      copy_ap_of(aut);
+      copy_acceptance_of(aut);
+    }
+
+    const spot::state* get_init_state() const override
+    {
+      return new counted_state(aut_->get_init_state());
+    }
+
+    spot::twa_succ_iterator*
+    succ_iter(const spot::state* s) const override
+    {
+      auto cs = static_cast<const counted_state*>(s);
+      return new counted_succ_iterator(aut_, aut_->succ_iter(cs->inner()));
+    }
+
+    std::string format_state(const spot::state* s) const override
+    {
+      return aut_->format_state(static_cast<const counted_state*>(s)
+                                ->inner());
+    }
+
+  private:
+    spot::const_twa_ptr aut_;
+  };
+
+  bool bulk = false;
+}
+
+// Print the successors of every reachable state of AUT.
+static void
+explore(const spot::const_twa_ptr& aut, const char* name)
+{
+  std::cout << "== " << name << '\n';
+  {
+    spot::state_unicity_table seen;
+    std::deque<const spot::state*> todo;
+    todo.push_back(seen(aut->get_init_state()));
+    std::vector<spot::twa_succ_entry> succs;
+    while (!todo.empty())
+      {
+        const spot::state* s = todo.front();
+        todo.pop_front();
+        std::cout << aut->format_state(s) << '\n';
+        spot::twa_succ_iterator* it = aut->succ_iter(s);
+        succs.clear();
+        // fill_succ() must append to existing entries.
+        succs.push_back({nullptr, bddfalse, 0U});
+        if (!bulk || !it->fill_succ(succs))
+          {
+            if (bulk)
+              std::cout << "  fill_succ() not supported\n";
+            if (it->first())
+              do
+                succs.push_back({it->dst(), it->cond(), it->acc()});
+              while (it->next());
+          }
+        aut->release_iter(it);
+        for (size_t i = 1; i < succs.size(); ++i)
+          {
+            auto& e = succs[i];
+            std::cout << "  " << spot::bdd_format_formula(aut->get_dict(),
+                                                         e.cond)
+                      << ' ' << e.acc << " -> "
+                      << aut->format_state(e.dst) << '\n';
+            if (const spot::state* d = seen.is_new(e.dst))
+              todo.push_back(d);
+          }
+      }
+  }
+  if (live_states)
+    std::cout << live_states << " live states\n";
+}
+
+static spot::kripke_graph_ptr
+random_kripke(const spot::bdd_dict_ptr& d, unsigned n,
+              const spot::atomic_prop_set& aps)
+{
+  auto k = spot::make_kripke_graph(d);
+  std::vector<bdd> vars;
+  for (auto& ap: aps)
+    vars.push_back(bdd_ithvar(k->register_ap(ap)));
+  for (unsigned i = 0; i < n; ++i)
+    {
+      bdd cond = bddtrue;
+      for (bdd v: vars)
+        cond &= spot::drand() < 0.5 ? v : !v;
+      k->new_state(cond);
+    }
+  for (unsigned i = 0; i < n; ++i)
+    for (unsigned j = 0; j < 3; ++j)
+      k->new_edge(i, spot::rrand(0, n - 1));
+  return k;
+}
+
+static void
+explore_all(const spot::twa_graph_ptr& g1, const spot::twa_graph_ptr& g2,
+            const spot::twa_graph_ptr& g3, const spot::kripke_graph_ptr& k,
+            const spot::const_twa_ptr& taa)
+{
+  explore(g1, "twa_graph");
+  explore(k, "kripke_graph");
+  explore(spot::otf_product(g1, g2), "product of twa_graph");
+  explore(spot::otf_product(spot::otf_product(g1, g2), g2),
+          "nested product");
+  explore(spot::otf_product(taa, g1), "product with TAA");
+  explore(spot::otf_product(k, g2), "product of kripke_graph");
+  // The right operand has states without successors, while the
+  // left one has none.
+  explore(spot::otf_product(std::make_shared<counted_twa>(g1),
+                            std::make_shared<counted_twa>(g3)),
+          "product with dead ends");
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+    return 2;
+  bulk = !strcmp(argv[1], "bulk");
+  auto d = spot::make_bdd_dict();
+  auto aps = spot::create_atomic_prop_set(2);
+  auto p0 = spot::formula::ap("p0");
+  auto p1 = spot::formula::ap("p1");
+  // Iterators of a TAA do not implement fill_succ().
+  auto taa = spot::ltl_to_taa(spot::formula::U(p0, spot::formula::G(p1)), d);
+
+  if (argc > 2)
+    {
+      int seeds = atoi(argv[2]);
+      for (int seed = 0; seed < seeds; ++seed)
+        {
+          std::cout << "* seed " << seed << '\n';
+          spot::srand(seed);
+          auto g1 = spot::random_graph(10 + seed, 0.2, &aps, d, 1, 0.3);
+          auto g2 = spot::random_graph(10, 0.3, &aps, d, 2, 0.3);
+          auto g3 = spot::random_graph(10, 0.3, &aps, d, 1, 0.3);
+          g3->new_states(3);
+          for (unsigned s = 0; s < 10; s += 3)
+            g3->new_edge(s, 10 + s / 4, bddtrue);
+          auto k = random_kripke(d, 15, aps);
+          explore_all(g1, g2, g3, k, taa);
+        }
+      return 0;
+    }
+
+  auto g1 = spot::make_twa_graph(d);
+  bdd b0 = bdd_ithvar(g1->register_ap(p0));
+  bdd b1 = bdd_ithvar(g1->register_ap(p1));
+  g1->set_buchi();
+  g1->new_states(3);
+  g1->new_edge(0, 0, b0, {0});
+  g1->new_edge(0, 1, !b0);
+  g1->new_edge(1, 2, b1);
+  g1->new_edge(1, 0, !b1, {0});
+  g1->new_edge(2, 2, bddtrue);
+
+  auto g2 = spot::make_twa_graph(d);
+  g2->register_ap(p0);
+  g2->register_ap(p1);
+  g2->set_generalized_buchi(2);
+  g2->new_states(2);
+  g2->new_edge(0, 1, b1, {0});
+  g2->new_edge(1, 0, bddtrue, {1});
+  g2->new_edge(1, 1, !b0);
+
+  // State 1 has no successor.
+  auto g3 = spot::make_twa_graph(d);
+  g3->register_ap(p0);
+  g3->register_ap(p1);
+  g3->new_states(2);
+  g3->new_edge(0, 0, b0);
+  g3->new_edge(0, 1, b1);
+
+  auto k = spot::make_kripke_graph(d);
+  k->register_ap(p0);
+  k->register_ap(p1);
+  k->new_state(!b0 & b1);
+  k->new_state(b0 & !b1);
+  k->new_state(b0 & b1);
+  k->new_edge(0, 1);
+  k->new_edge(0, 2);
+  k->new_edge(1, 0);
+  k->new_edge(2, 2);
+
+  explore_all(g1, g2, g3, k, taa);
+  return 0;
+}
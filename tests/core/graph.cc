@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014, 2015, 2016, 2017 Laboratoire de Recherche et
+// Copyright (C) 2014-2018 Laboratoire de Recherche et
 // Développement de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -19,6 +19,7 @@
 
 
 #include <iostream>
+#include <sstream>
 #include <spot/graph/graph.hh>
 
 template <typename SL, typename TL>
@@ -297,6 +298,88 @@ f8()
   return f == 69;
 }
 
+static bool
+f9()
+{
+  spot::digraph<void, int> g(3);
+
+  auto s1 = g.new_state();
+  auto s2 = g.new_state();
+  auto s3 = g.new_state();
+  g.new_edge(s3, s2, 1);
+  g.new_edge(s1, s2, 2);
+  g.new_edge(s2, s3, 3);
+  g.new_edge(s1, s3, 4);
+  g.new_edge(s3, s3, 5);
+  g.new_edge(s1, s1, 6);
+  for (auto i = g.out_iteraser(s1); i;)
+    if (i->data() == 4)
+      i.erase();
+    else
+      ++i;
+
+  if (g.is_frozen() || !g.freeze() || !g.is_frozen())
+    return false;
+  g.dump_storage(std::cout);
+  dot(std::cout, g);
+
+  int f = 0;
+  for (unsigned s = 0; s < 3; ++s)
+    {
+      auto o = g.out(s).begin();
+      for (auto& t: g.frozen_out(s))
+        {
+          if (&t != &*o)
+            return false;
+          f += t.data();
+          ++o;
+        }
+      if (o != g.out(s).end())
+        return false;
+    }
+  // Freezing again does not renumber anything, and adding an edge
+  // unfreezes the graph.
+  if (!g.is_frozen() || g.freeze())
+    return false;
+  g.new_edge(s2, s1, 7);
+  return f == 17 && !g.is_frozen() && g.edge_offsets().empty();
+}
+
+// Renumber and remove states of a random graph with one thread, and
+// with four threads processing at least one edge each, and check that
+// the storage is the same.
+static bool
+f10()
+{
+  std::string res[2];
+  for (int i = 0; i < 2; ++i)
+    {
+      spot::digraph<void, int> g(50);
+      g.new_states(50);
+      std::vector<unsigned> newst(50);
+      unsigned used = 0;
+      for (unsigned s = 0; s < 50; ++s)
+        newst[s] = s % 7 == 3 ? -1U : used++;
+      unsigned r = 1;
+      for (unsigned s = 0; s < 50; ++s)
+        for (unsigned k = 0; k < 5; ++k)
+          {
+            r = r * 1103515245 + 12345;
+            unsigned d = (r >> 16) % 50;
+            // Live states should only lead to live states.
+            if (newst[s] != -1U && newst[d] == -1U)
+              ++d;
+            g.new_edge(s, d, int(r >> 24));
+          }
+      g.defrag_states(std::move(newst), used,
+                      i ? spot::parallel_policy(4, 1)
+                        : spot::parallel_policy(1));
+      std::ostringstream os;
+      g.dump_storage(os);
+      res[i] = os.str();
+    }
+  return res[0] == res[1];
+}
 
 int main()
 {
@@ -308,6 +391,8 @@ int main()
   bool a6 = f6();
   bool a7 = f7();
   bool a8 = f8();
+  bool a9 = f9();
+  bool a10 = f10();
   std::cout << a1 << ' '
             << a2 << ' '
             << a3 << ' '
@@ -315,6 +400,8 @@ int main()
             << a5 << ' '
             << a6 << ' '
             << a7 << ' '
-            << a8 << '\n';
-  return !(a1 && a2 && a3 && a4 && a5 && a6 && a7 && a8);
+            << a8 << ' '
+            << a9 << ' '
+            << a10 << '\n';
+  return !(a1 && a2 && a3 && a4 && a5 && a6 && a7 && a8 && a9 && a10);
 }
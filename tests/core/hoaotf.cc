@@ -0,0 +1,231 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Build an on-the-fly automaton with N states, and print it with
+// print_hoa() and option OPT.  With a third argument, make the
+// output stream fail after every possible number of characters,
+// with and without exceptions, and summarize what happened, in
+// particular the number of states that were not destroyed.
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <streambuf>
+#include <spot/twa/twa.hh>
+#include <spot/twaalgos/hoa.hh>
+
+namespace
+{
+  int live_states = 0;
+
+  class int_state final: public spot::state
+  {
+  public:
+    explicit int_state(unsigned v)
+      : v_(v)
+    {
+      ++live_states;
+    }
+
+    int compare(const spot::state* other) const override
+    {
+      unsigned o = static_cast<const int_state*>(other)->v_;
+      return (v_ > o) - (v_ < o);
+    }
+
+    size_t hash() const override
+    {
+      return v_;
+    }
+
+    int_state* clone() const override
+    {
+      return new int_state(v_);
+    }
+
+    unsigned value() const
+    {
+      return v_;
+    }
+
+  private:
+    ~int_state()
+    {
+      --live_states;
+    }
+
+    unsigned v_;
+  };
+
+  // State i goes to i+1 on p0, and to 2i on !p0 (modulo n).  The
+  // edges leaving multiples of 3 are accepting.
+  class int_succ_iterator final: public spot::twa_succ_iterator
+  {
+  public:
+    int_succ_iterator(unsigned v, unsigned n, bdd p0)
+      : v_(v), n_(n), p0_(p0)
+    {
+    }
+
+    bool first() override
+    {
+      pos_ = 0;
+      return true;
+    }
+
+    bool next() override
+    {
+      return ++pos_ < 2;
+    }
+
+    bool done() const override
+    {
+      return pos_ >= 2;
+    }
+
+    const spot::state* dst() const override
+    {
+      return new int_state(pos_ ? (2 * v_) % n_ : (v_ + 1) % n_);
+    }
+
+    bdd cond() const override
+    {
+      return pos_ ? !p0_ : p0_;
+    }
+
+    spot::acc_cond::mark_t acc() const override
+    {
+      if (v_ % 3)
+        return 0U;
+      return {0};
+    }
+
+  private:
+    unsigned v_;
+    unsigned n_;
+    bdd p0_;
+    unsigned pos_ = 0;
+  };
+
+  class int_twa final: public spot::twa
+  {
+  public:
+    int_twa(const spot::bdd_dict_ptr& d, unsigned n)
+      : twa(d), n_(n)
+    {
+      p0_ = bdd_ithvar(register_ap("p0"));
+      set_buchi();
+    }
+
+    const spot::state* get_init_state() const override
+    {
+      return new int_state(0);
+    }
+
+    spot::twa_succ_iterator*
+    succ_iter(const spot::state* s) const override
+    {
+      unsigned v = static_cast<const int_state*>(s)->value();
+      return new int_succ_iterator(v, n_, p0_);
+    }
+
+    std::string format_state(const spot::state* s) const override
+    {
+      return std::to_string(static_cast<const int_state*>(s)->value());
+    }
+
+  private:
+    unsigned n_;
+    bdd p0_;
+  };
+
+  // A stream buffer that accepts LIMIT characters, and then fails.
+  class limited_buf final: public std::streambuf
+  {
+  public:
+    explicit limited_buf(size_t limit)
+      : left_(limit)
+    {
+    }
+
+  protected:
+    int_type overflow(int_type c) override
+    {
+      if (left_ == 0)
+        return traits_type::eof();
+      --left_;
+      return traits_type::not_eof(c);
+    }
+
+  private:
+    size_t left_;
+  };
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 3)
+    return 2;
+  unsigned n = atoi(argv[1]);
+  const char* opt = argv[2];
+  auto aut = std::make_shared<int_twa>(spot::make_bdd_dict(), n);
+  if (argc == 3)
+    {
+      spot::print_hoa(std::cout, aut, opt) << '\n';
+      if (live_states)
+        std::cout << live_states << " live states\n";
+      return 0;
+    }
+
+  std::ostringstream out;
+  spot::print_hoa(out, aut, opt);
+  size_t len = out.str().size();
+  for (bool exc: {false, true})
+    {
+      unsigned thrown = 0;
+      unsigned good = 0;
+      unsigned leaks = 0;
+      for (size_t limit = 0; limit < len; ++limit)
+        {
+          limited_buf buf(limit);
+          std::ostream os(&buf);
+          if (exc)
+            os.exceptions(std::ios::badbit);
+          try
+            {
+              spot::print_hoa(os, aut, opt);
+            }
+          catch (const std::ios::failure&)
+            {
+              ++thrown;
+            }
+          good += os.good();
+          if (live_states)
+            {
+              ++leaks;
+              live_states = 0;
+            }
+        }
+      std::cout << n << ' ' << opt << (exc ? " with" : " without")
+                << " exceptions: " << len << " limits, "
+                << thrown << " thrown, " << good << " good, "
+                << leaks << " leaking\n";
+    }
+  return 0;
+}
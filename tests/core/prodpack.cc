@@ -0,0 +1,194 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// The product of two twa_graph uses state_product_packed, while the
+// product of other automata uses state_product.  Run emptiness checks
+// on the products of two automata, and print their verdicts,
+// statistics, counterexamples, and projected counterexamples.  With
+// "graph" as first argument, the operands are twa_graph; with
+// "wrapped", they are hidden behind a forwarding automaton.  Apart
+// from the type of the states, printed first for the small automata,
+// the output should be the same.  Without a second argument, small
+// automata built below are used.  Otherwise, the argument is the
+// number of random pairs of automata to use.
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <spot/twa/twagraph.hh>
+#include <spot/twa/twaproduct.hh>
+#include <spot/twaalgos/randomgraph.hh>
+#include <spot/twaalgos/emptiness.hh>
+#include <spot/tl/apcollect.hh>
+#include <spot/misc/random.hh>
+
+namespace
+{
+  // An automaton that behaves like a twa_graph without being one.
+  class graph_wrapper final: public spot::twa
+  {
+  public:
+    explicit graph_wrapper(const spot::const_twa_graph_ptr& g)
+      : twa(g->get_dict()), g_(g)
+    {
+      copy_ap_of(g);
+      copy_acceptance_of(g);
+    }
+
+    const spot::state* get_init_state() const override
+    {
+      return g_->get_init_state();
+    }
+
+    spot::twa_succ_iterator*
+    succ_iter(const spot::state* s) const override
+    {
+      return g_->succ_iter(s);
+    }
+
+    std::string format_state(const spot::state* s) const override
+    {
+      return g_->format_state(s);
+    }
+
+  private:
+    spot::const_twa_graph_ptr g_;
+  };
+}
+
+// Run all emptiness checks on PROD, whose operands are LEFT and
+// RIGHT, and describe their results.
+static void
+check(const spot::twa_product_ptr& prod,
+      const spot::const_twa_ptr& left, const spot::const_twa_ptr& right)
+{
+  static const char* algos[] = {
+    "Cou99", "Cou99(shy)", "Cou99(poprem)", "Cou99new", "CVWY90",
+    "GV04", "SE05", "Tau03", "Tau03_opt",
+  };
+  for (const char* algo: algos)
+    {
+      const char* err;
+      auto inst = spot::make_emptiness_check_instantiator(algo, &err);
+      if (!inst)
+        {
+          std::cerr << "unknown algorithm " << err << '\n';
+          exit(2);
+        }
+      if (prod->num_sets() > inst->max_sets()
+          || prod->num_sets() < inst->min_sets())
+        continue;
+      auto ec = inst->instantiate(prod);
+      auto res = ec->check();
+      std::cout << algo << ": " << (res ? "non-empty" : "empty");
+      if (auto st = ec->statistics())
+        for (auto& k: st->stats)
+          if (strcmp(k.first, "vmsize"))
+            std::cout << ' ' << k.first << '=' << (st->*k.second)();
+      std::cout << '\n';
+      if (!res)
+        continue;
+      auto run = res->accepting_run();
+      if (!run)
+        continue;
+      std::cout << *run;
+      if (!run->replay(std::cout))
+        std::cout << "replay failed\n";
+      std::cout << "left projection:\n" << *run->project(left)
+                << "right projection:\n" << *run->project(right, true);
+    }
+}
+
+static void
+check_all(const spot::const_twa_graph_ptr& a,
+          const spot::const_twa_graph_ptr& b,
+          unsigned sa, unsigned sb, bool wrapped)
+{
+  spot::const_twa_ptr wa = a;
+  spot::const_twa_ptr wb = b;
+  if (wrapped)
+    {
+      wa = std::make_shared<graph_wrapper>(a);
+      wb = std::make_shared<graph_wrapper>(b);
+    }
+  std::cout << "** otf_product()\n";
+  check(spot::otf_product(wa, wb), wa, wb);
+  // Starting elsewhere exercises twa_product_init.
+  std::cout << "** otf_product_at(" << sa << ", " << sb << ")\n";
+  check(spot::otf_product_at(wa, wb, a->state_from_number(sa),
+                             b->state_from_number(sb)), wa, wb);
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+    return 2;
+  bool wrapped = !strcmp(argv[1], "wrapped");
+  auto d = spot::make_bdd_dict();
+
+  if (argc > 2)
+    {
+      auto aps = spot::create_atomic_prop_set(3);
+      int seeds = atoi(argv[2]);
+      for (int seed = 0; seed < seeds; ++seed)
+        {
+          std::cout << "* seed " << seed << '\n';
+          spot::srand(seed);
+          unsigned n = 10 + seed;
+          auto a = spot::random_graph(n, 4.0 / n, &aps, d, 1, 0.03);
+          auto b = spot::random_graph(n, 4.0 / n, &aps, d, seed % 3, 0.03);
+          check_all(a, b, seed % n, (seed / 2) % n, wrapped);
+        }
+      return 0;
+    }
+
+  auto a = spot::make_twa_graph(d);
+  bdd p0 = bdd_ithvar(a->register_ap("p0"));
+  bdd p1 = bdd_ithvar(a->register_ap("p1"));
+  a->set_buchi();
+  a->new_states(3);
+  a->new_edge(0, 0, bddtrue);
+  a->new_edge(0, 1, p0);
+  a->new_edge(1, 2, p1, {0});
+  a->new_edge(2, 1, !p0);
+  a->new_edge(2, 2, p0 & p1);
+
+  auto b = spot::make_twa_graph(d);
+  b->copy_ap_of(a);
+  b->set_buchi();
+  b->new_states(2);
+  b->new_edge(0, 1, p1);
+  b->new_edge(1, 0, bddtrue, {0});
+  b->new_edge(1, 1, !p0);
+
+  {
+    auto p = spot::otf_product(a, b);
+    if (wrapped)
+      p = spot::otf_product(std::make_shared<graph_wrapper>(a),
+                            std::make_shared<graph_wrapper>(b));
+    const spot::state* i = p->get_init_state();
+    if (dynamic_cast<const spot::state_product_packed*>(i))
+      std::cout << "states: state_product_packed\n";
+    else if (dynamic_cast<const spot::state_product*>(i))
+      std::cout << "states: state_product\n";
+    i->destroy();
+  }
+  check_all(a, b, 2, 1, wrapped);
+  return 0;
+}
@@ -0,0 +1,107 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Print the products of two automata, built with the number of
+// threads given as first argument.  The grain of the parallel_policy
+// is lowered to 1 so that threads are started even on small levels.
+// The output should not depend on the number of threads.  Without a
+// second argument, small automata built below are used.  Otherwise,
+// the argument is the number of random pairs of automata to use.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <spot/twa/twagraph.hh>
+#include <spot/twaalgos/product.hh>
+#include <spot/twaalgos/randomgraph.hh>
+#include <spot/twaalgos/hoa.hh>
+#include <spot/tl/apcollect.hh>
+#include <spot/misc/random.hh>
+
+static void
+print(const spot::twa_graph_ptr& aut)
+{
+  spot::print_hoa(std::cout, aut) << '\n';
+  auto* ps = aut->get_named_prop<spot::product_states>("product-states");
+  std::cout << "product-states:";
+  for (auto& p: *ps)
+    std::cout << ' ' << p.first << ',' << p.second;
+  std::cout << '\n';
+}
+
+static void
+print_products(const spot::const_twa_graph_ptr& left,
+               const spot::const_twa_graph_ptr& right,
+               unsigned ls, unsigned rs, unsigned nthreads)
+{
+  spot::parallel_policy pp(nthreads, 1);
+  print(spot::product(left, right, pp));
+  print(spot::product(left, right, ls, rs, pp));
+  print(spot::product_or(left, right, pp));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+    return 2;
+  unsigned nthreads = atoi(argv[1]);
+  auto d = spot::make_bdd_dict();
+
+  if (argc > 2)
+    {
+      auto aps = spot::create_atomic_prop_set(3);
+      int seeds = atoi(argv[2]);
+      for (int seed = 0; seed < seeds; ++seed)
+        {
+          std::cout << "* seed " << seed << '\n';
+          spot::srand(seed);
+          unsigned n = 5 + seed % 80;
+          unsigned m = 3 + seed % 20;
+          auto left = spot::random_graph(n, std::min(0.9, 3.0 / n), &aps, d,
+                                         seed % 3, 0.2);
+          auto right = spot::random_graph(m, std::min(0.9, 4.0 / m), &aps, d,
+                                          seed % 2, 0.2);
+          print_products(left, right, seed % n, seed % m, nthreads);
+        }
+      return 0;
+    }
+
+  auto left = spot::make_twa_graph(d);
+  bdd p0 = bdd_ithvar(left->register_ap("p0"));
+  bdd p1 = bdd_ithvar(left->register_ap("p1"));
+  left->set_buchi();
+  left->new_states(3);
+  left->new_edge(0, 0, bddtrue);
+  left->new_edge(0, 1, p0);
+  left->new_edge(1, 2, p1, {0});
+  left->new_edge(1, 0, !p1);
+  left->new_edge(2, 2, p0, {0});
+  left->new_edge(2, 1, !p0);
+
+  auto right = spot::make_twa_graph(d);
+  right->copy_ap_of(left);
+  right->set_co_buchi();
+  right->new_states(2);
+  right->new_edge(0, 1, p0 | p1);
+  right->new_edge(1, 0, !p0, {0});
+  right->new_edge(1, 1, p1);
+
+  print_products(left, right, 1, 1, nthreads);
+  return 0;
+}
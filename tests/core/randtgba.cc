@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2008-2012, 2014-2017 Laboratoire de Recherche et
+// Copyright (C) 2008-2012, 2014-2018 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 // Copyright (C) 2004, 2005 Laboratoire d'Informatique de Paris
 // 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
@@ -72,6 +72,7 @@ const char* default_algos[] = {
   "GV04",
   "SE05",
   "SE05(bsh=4K)",
+  "SE05(swarm=3)",
   "Tau03",
   "Tau03_opt",
   "Tau03_opt(condstack)",
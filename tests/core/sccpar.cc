@@ -0,0 +1,189 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Print the SCCs computed by scc_info, sequentially if the first
+// argument is 0, or with the PARALLEL option and this number of
+// threads otherwise.  The grain of the parallel_policy is lowered to
+// 1 so that threads are started even on small automata.  The output
+// does not depend on the numbering of the SCCs, so it should not
+// depend on the number of threads either.  Without a second
+// argument, a small automaton built below is used.  Otherwise, the
+// argument is the number of random automata to use.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <spot/twaalgos/sccinfo.hh>
+#include <spot/twaalgos/randomgraph.hh>
+#include <spot/tl/apcollect.hh>
+#include <spot/misc/random.hh>
+
+static void
+print_sccs(const spot::const_twa_graph_ptr& aut, spot::scc_info_options opt,
+           unsigned nthreads)
+{
+  std::cout << "** options " << static_cast<int>(opt) << '\n';
+  if (nthreads)
+    opt = opt | spot::scc_info_options::PARALLEL;
+  spot::scc_info si(aut, opt, spot::parallel_policy(nthreads, 1));
+  unsigned k = si.scc_count();
+  unsigned ns = aut->num_states();
+
+  // SCCs are listed in the order of their smallest state.
+  std::vector<std::vector<unsigned>> states(k);
+  for (unsigned s = 0; s < ns; ++s)
+    {
+      unsigned x = si.scc_of(s);
+      if (x == -1U)
+        std::cout << "unreachable state " << s << '\n';
+      else
+        states[x].push_back(s);
+    }
+  std::vector<unsigned> order(k);
+  for (unsigned i = 0; i < k; ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](unsigned x, unsigned y)
+            {
+              return states[x].front() < states[y].front();
+            });
+
+  // With Fin acceptance, the parallel algorithm may leave more SCCs
+  // undetermined than the sequential one.
+  bool fin = aut->acc().uses_fin_acceptance();
+  for (unsigned i: order)
+    {
+      std::cout << "SCC";
+      for (unsigned s: states[i])
+        std::cout << ' ' << s;
+      std::cout << ": acc=" << si.acc_sets_of(i);
+      if (si.is_trivial(i))
+        std::cout << " trivial";
+      if (si.is_rejecting_scc(i))
+        std::cout << " rejecting";
+      if (!fin && si.is_accepting_scc(i))
+        std::cout << " accepting";
+      if (si.scc_of(si.one_state_of(i)) != i)
+        std::cout << " (wrong one_state_of)";
+      if (!!(opt & spot::scc_info_options::TRACK_STATES))
+        {
+          auto& ss = si.states_of(i);
+          if (std::set<unsigned>(ss.begin(), ss.end())
+              != std::set<unsigned>(states[i].begin(), states[i].end()))
+            std::cout << " (wrong states_of)";
+        }
+      if (!!(opt & spot::scc_info_options::TRACK_SUCCS))
+        {
+          if (!fin && si.is_useful_scc(i))
+            std::cout << " useful";
+          std::set<unsigned> succs;
+          for (unsigned j: si.succ(i))
+            succs.insert(states[j].front());
+          std::cout << " succs:";
+          for (unsigned s: succs)
+            std::cout << ' ' << s;
+        }
+      std::cout << '\n';
+    }
+
+  // SCCs should be numbered in reverse topological order, with the
+  // initial SCC last.
+  if (k && si.initial() != k - 1)
+    std::cout << "initial SCC is not last\n";
+  for (auto& e: aut->edges())
+    if (si.reachable_state(e.src))
+      for (unsigned d: aut->univ_dests(e.dst))
+        if (si.scc_of(e.src) < si.scc_of(d))
+          std::cout << "edge " << e.src << "->" << d
+                    << " breaks the topological order\n";
+}
+
+static void
+print_all(const spot::const_twa_graph_ptr& aut, unsigned nthreads)
+{
+  for (auto opt: {spot::scc_info_options::ALL,
+                  spot::scc_info_options::NONE,
+                  spot::scc_info_options::TRACK_STATES,
+                  spot::scc_info_options::TRACK_SUCCS})
+    print_sccs(aut, opt, nthreads);
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+    return 2;
+  unsigned nthreads = atoi(argv[1]);
+  auto d = spot::make_bdd_dict();
+  auto aps = spot::create_atomic_prop_set(2);
+
+  if (argc > 2)
+    {
+      int seeds = atoi(argv[2]);
+      for (int seed = 0; seed < seeds; ++seed)
+        {
+          std::cout << "* seed " << seed << '\n';
+          spot::srand(seed);
+          unsigned n = 1 + seed % 97;
+          double density = (seed % 5 + 1) * 0.4 / n;
+          auto aut = spot::random_graph(n, density, &aps, d,
+                                        1 + seed % 3, 0.2);
+          if (seed % 4 == 1)
+            aut->set_acceptance(2, spot::acc_cond::acc_code::rabin(1));
+          // A chain of 50 states, closed into a ring every other time.
+          if (seed % 3 == 0)
+            {
+              unsigned b = aut->new_states(50);
+              aut->new_edge(spot::rrand(0, n - 1), b, bddtrue);
+              for (unsigned i = 0; i < 49; ++i)
+                aut->new_edge(b + i, b + i + 1, bddtrue, {0});
+              if (seed % 2)
+                aut->new_edge(b + 49, b, bddtrue);
+              aut->new_edge(b + 25, spot::rrand(0, n - 1), bddtrue);
+            }
+          if (seed % 7 == 3)
+            {
+              unsigned s = aut->num_states();
+              aut->new_univ_edge(spot::rrand(0, s - 1),
+                                 {unsigned(spot::rrand(0, s - 1)),
+                                  unsigned(spot::rrand(0, s - 1))},
+                                 bddtrue);
+            }
+          print_all(aut, nthreads);
+        }
+      return 0;
+    }
+
+  // Two accepting SCCs, one of which is reached through a universal
+  // edge, a rejecting SCC, a trivial SCC, and an unreachable state.
+  auto aut = spot::make_twa_graph(d);
+  aut->set_generalized_buchi(2);
+  aut->new_states(8);
+  aut->new_edge(0, 1, bddtrue);
+  aut->new_edge(1, 2, bddtrue, {0});
+  aut->new_edge(2, 1, bddtrue, {1});
+  aut->new_edge(1, 3, bddtrue);
+  aut->new_edge(3, 3, bddtrue);
+  aut->new_edge(3, 4, bddtrue);
+  aut->new_univ_edge(0, {5, 6}, bddtrue);
+  aut->new_edge(5, 6, bddtrue, {0, 1});
+  aut->new_edge(6, 5, bddtrue);
+  aut->new_edge(7, 0, bddtrue);
+  print_all(aut, nthreads);
+  return 0;
+}
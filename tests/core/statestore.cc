@@ -0,0 +1,166 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2018 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Apply the insertions, lookups, and erasures read on the standard
+// input to a state_store, and print their results.  The states hash
+// to their value modulo the number of buckets given as argument, so
+// that a small number of buckets makes probe sequences long and
+// forces erasures to shift many entries.  The output should not
+// depend on this number.
+//
+// Each input line is one of the following operations, where V is
+// an integer.
+//   +V  insert V, associated to the line number, unless present
+//   -V  erase V
+//   ?V  look V up
+//   !V  increment the value of V, if present
+//   =   print the content of the store, sorted by state
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <spot/twa/twa.hh>
+
+namespace
+{
+  int live_states = 0;
+
+  class int_state final: public spot::state
+  {
+  public:
+    int_state(int v, unsigned buckets)
+      : v_(v), buckets_(buckets)
+    {
+      ++live_states;
+    }
+
+    int compare(const spot::state* other) const override
+    {
+      int o = static_cast<const int_state*>(other)->v_;
+      return (v_ > o) - (v_ < o);
+    }
+
+    size_t hash() const override
+    {
+      return v_ % buckets_;
+    }
+
+    int_state* clone() const override
+    {
+      return new int_state(v_, buckets_);
+    }
+
+    int value() const
+    {
+      return v_;
+    }
+
+  private:
+    ~int_state()
+    {
+      --live_states;
+    }
+
+    int v_;
+    unsigned buckets_;
+  };
+
+  int value(const spot::state* s)
+  {
+    return static_cast<const int_state*>(s)->value();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+    return 2;
+  unsigned buckets = atoi(argv[1]);
+  if (!buckets)
+    return 2;
+  spot::state_store<int> store;
+  std::string line;
+  for (int num = 1; std::getline(std::cin, line); ++num)
+    {
+      if (line.empty())
+        continue;
+      std::cout << line << ':';
+      if (line[0] == '=')
+        {
+          std::map<int, int> content;
+          for (auto& p: store)
+            content[value(p.first)] = p.second;
+          for (auto& p: content)
+            std::cout << ' ' << p.first << '=' << p.second;
+          std::cout << " (" << store.size() << " states)\n";
+          continue;
+        }
+      int v = atoi(line.c_str() + 1);
+      auto probe = new int_state(v, buckets);
+      switch (line[0])
+        {
+        case '+':
+          {
+            auto s = new int_state(v, buckets);
+            auto p = store.emplace(s, num);
+            if (!p.second)
+              s->destroy();
+            std::cout << (p.second ? " new " : " old ")
+                      << value(p.first->first) << '=' << p.first->second;
+            break;
+          }
+        case '-':
+          {
+            auto i = store.find(probe);
+            const spot::state* key = i == store.end() ? nullptr : i->first;
+            std::cout << ' ' << store.erase(probe);
+            if (key)
+              key->destroy();
+            break;
+          }
+        case '?':
+          {
+            auto i = store.find(probe);
+            if (i == store.end())
+              std::cout << " absent";
+            else
+              std::cout << ' ' << value(i->first) << '=' << i->second;
+            break;
+          }
+        case '!':
+          if (store.find(probe) != store.end())
+            std::cout << ' ' << ++store[probe];
+          else
+            std::cout << " absent";
+          break;
+        default:
+          std::cerr << "unknown operation: " << line << '\n';
+          return 2;
+        }
+      probe->destroy();
+      std::cout << '\n';
+    }
+  store.destroy_states();
+  if (!store.empty() || store.begin() != store.end())
+    std::cout << "store not empty\n";
+  if (live_states)
+    std::cout << live_states << " live states\n";
+  return 0;
+}
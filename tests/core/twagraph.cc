@@ -146,10 +146,36 @@ static void f4()
   spot::print_hoa(std::cout, tg, "1.1") << '\n';
 }
 
+// The sequential and parallel versions of merge_edges() should both
+// merge the first edges.  Groups of eight parallel edges reuse their
+// label enough for the parallel version to be used.
+static void f5()
+{
+  for (unsigned nthreads: {1, 4})
+    {
+      auto d = spot::make_bdd_dict();
+      auto tg = make_twa_graph(d);
+      bdd p1 = bdd_ithvar(tg->register_ap("p1"));
+      bdd p2 = bdd_ithvar(tg->register_ap("p2"));
+      tg->set_generalized_buchi(8);
+
+      auto s1 = tg->new_state();
+      auto s2 = tg->new_state();
+      for (unsigned i = 0; i < 8; ++i)
+        tg->new_edge(s1, s1, p1, {i});
+      tg->new_edge(s1, s2, p2, {0});
+      for (unsigned i = 0; i < 8; ++i)
+        tg->new_edge(s2, s1, p1, {i});
+      tg->merge_edges(spot::parallel_policy(nthreads, 1));
+      spot::print_hoa(std::cout, tg) << '\n';
+    }
+}
+
 int main()
 {
   f1();
   f2();
   f3();
   f4();
+  f5();
 }
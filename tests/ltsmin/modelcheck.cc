@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017 Laboratoire de
+// Copyright (C) 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Laboratoire de
 // Recherche et Developpement de l'Epita (LRDE)
 //
 // This file is part of Spot, a model checking library.
@@ -52,6 +52,7 @@ Options:\n\
   -gm    output the model state-space in dot format\n\
   -gK    output the model state-space in Kripke format\n\
   -gp    output the product state-space in dot format\n\
+  -jN    explore the model with N threads before using it\n\
   -T     time the different phases of the execution\n\
   -z     compress states to handle larger models\n\
   -Z     compress states (faster) assuming all values in [0 .. 2^28-1]\n\
@@ -73,6 +74,7 @@ checked_main(int argc, char **argv)
   bool deterministic = false;
   char *dead = nullptr;
   int compress_states = 0;
+  int explore_threads = 0;
 
   const char* echeck_algo = "Cou99";
 
@@ -124,6 +126,11 @@ checked_main(int argc, char **argv)
                   goto error;
                 }
               break;
+            case 'j':
+              explore_threads = atoi(opt + 1);
+              if (explore_threads <= 0)
+                goto error;
+              break;
             case 'T':
               use_timer = true;
               break;
@@ -218,8 +225,12 @@ checked_main(int argc, char **argv)
       tm.start("loading ltsmin model");
       try
         {
-          model = spot::ltsmin_model::load(argv[1]).kripke(&ap, dict, deadf,
-                                                           compress_states);
+          auto m = spot::ltsmin_model::load(argv[1]);
+          if (explore_threads)
+            model = m.explicit_kripke(&ap, dict, deadf, compress_states,
+                                      spot::parallel_policy(explore_threads));
+          else
+            model = m.kripke(&ap, dict, deadf, compress_states);
         }
       catch (std::runtime_error& e)
         {
@@ -1,5 +1,5 @@
 # -*- mode: python; coding: utf-8 -*-
-# Copyright (C) 2015, 2017  Laboratoire de Recherche et Développement
+# Copyright (C) 2015, 2017, 2018  Laboratoire de Recherche et Développement
 # de l'Epita
 #
 # This file is part of Spot, a model checking library.
@@ -91,6 +91,9 @@ State: 2 "{₀[0]₀}{₁[1]₁}"
 [0&!1] 0 {1}
 [0&1] 1 {3}
 --END--"""
+# These names are stored in a string_pool, and converted on demand.
+assert list(daut.get_state_names()) == ["{₀[0]₀}", "{₀[0]{₂[2]₂}₀}{₁[1]₁}",
+                                        "{₀[0]₀}{₁[1]₁}"]
 
 aut = spot.automaton("""
 HOA: v1